@@ -0,0 +1,49 @@
+#pragma once
+
+// Cost-model dispatch for the "Auto" scanner (patterns/auto.cpp).
+//
+// Each call is sorted into one cell of a decision table by pattern length, wildcard density, longest exact run, the
+// sampled share of the rarest exact byte in the data, and region size. The cell names the engine that runs the call.
+// The built-in table was fitted by --calibrate_auto on an AVX2 machine, and --auto_table loads one fitted elsewhere.
+
+#include "pattern_entry.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace auto_scanner
+{
+struct features
+{
+    size_t length {0};
+    double wildcard_density {0.0};
+    size_t longest_run {0};
+    double anchor_share {1.0}; // Sampled share of the rarest exact byte in the data. 1 when there is no exact byte.
+    size_t region_size {0};
+};
+
+// 4 lengths x 2 densities x 2 run lengths x 3 anchor shares x 2 region sizes.
+static constexpr size_t cell_count = 96;
+
+using decision_table = std::array<uint8_t, cell_count>;
+
+// Candidate engines, by registered scanner name. Table entries index this list.
+size_t engine_count();
+const char* engine_name(size_t engine);
+
+// A new instance of the engine, or of its scanner_traits::fallback when the host lacks its ISA. Nullptr when neither
+// is registered and runnable here.
+std::unique_ptr<pattern_scanner> create_engine(size_t engine);
+
+features measure(const compiled_pattern& pattern, const byte* data, size_t length);
+size_t cell_of(const features& f);
+std::string describe_cell(size_t cell);
+
+const decision_table& table();
+void set_table(const decision_table& cells);
+
+// One "<cell> <engine name>" line per cell. Cells missing from the file keep their current engine.
+bool load_table(const char* path, std::string& error);
+bool save_table(const char* path, const decision_table& cells);
+} // namespace auto_scanner
@@ -0,0 +1,67 @@
+#pragma once
+
+// Byte statistics and bit helpers shared by the scanners that pick which pattern bytes to filter on.
+
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Bytes that are common in x86 code and data, most common first.
+inline constexpr byte common_bytes[] = {0x00, 0xFF, 0xCC, 0x48, 0x8B, 0x89, 0x0F, 0xE8, 0x24, 0x4C, 0x8D, 0x01, 0x85,
+    0x74, 0x44, 0x83, 0x90, 0xC3, 0x10, 0x08, 0x20, 0x40, 0x45, 0xC0, 0x49, 0x41, 0x4D, 0x75, 0x33, 0x5C};
+
+// Rough rank of a byte in x86 code and data, higher is more common. Unlisted bytes count as rare.
+constexpr int commonness(byte value)
+{
+    for (size_t i = 0; i < sizeof(common_bytes); ++i)
+    {
+        if (common_bytes[i] == value)
+            return static_cast<int>(sizeof(common_bytes) - i);
+    }
+
+    return 0;
+}
+
+// Index of the lowest set bit of a nonzero mask, e.g. the first matching lane of a movemask.
+inline unsigned first_set_bit(uint32_t v)
+{
+    return static_cast<unsigned>(std::countr_zero(v));
+}
+
+// Byte counts over a sample of the data: up to 256 blocks of 256 bytes, spaced evenly over it, so the cost stays flat
+// in the data size. Scanners that plan from the data they are about to scan use it to steer away from common bytes.
+// Without data every byte value is equally likely.
+struct byte_sample
+{
+    static constexpr size_t block = 256;
+    static constexpr size_t max_blocks = 256;
+
+    uint32_t counts[256] {};
+    uint32_t total {0};
+
+    // log of the (smoothed) share of sampled bytes equal to each value.
+    double log_share[256] {};
+
+    byte_sample()
+        : byte_sample(nullptr, 0)
+    {}
+
+    byte_sample(const byte* data, size_t length);
+
+    // log of the (smoothed) share of sampled bytes that satisfy (b & mask) == value.
+    double masked_log_share(byte value, byte mask) const;
+
+    // Calls visit(block_start) for every sampled block, for scanners that count more than single bytes.
+    template <typename Visit>
+    static void for_each_block(const byte* data, size_t length, Visit&& visit)
+    {
+        const size_t blocks = (std::min)(length / block, max_blocks);
+        const size_t stride = blocks ? (length / blocks) : 0;
+
+        for (size_t i = 0; i < blocks; ++i)
+            visit(data + i * stride);
+    }
+};
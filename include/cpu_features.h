@@ -0,0 +1,153 @@
+#ifndef BENCH_CPU_FEATURES_H
+#define BENCH_CPU_FEATURES_H
+
+#include <cstdint>
+#include <string>
+
+// Marks a function as compiled for AVX2 + BMI1 (or SSE4.2, which includes SSE4.1) inside a translation unit built for
+// the baseline ISA. Only call it after checking DetectCpuFeatures(). MSVC emits intrinsics without any /arch flag.
+// BENCH_FORCE_SIMDE builds (see CMakeLists.txt) emulate the intrinsics through SIMDE and leave every target alone.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386)) && !defined(BENCH_FORCE_SIMDE)
+#  define BENCH_TARGET_AVX2 __attribute__((target("avx2,bmi")))
+#  define BENCH_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#  define BENCH_TARGET_AVX2
+#  define BENCH_TARGET_SSE42
+#endif
+
+// Compiles every function defined between BENCH_PUSH_TARGET_AVX2 (or _AVX2_BMI2) and BENCH_POP_TARGET for that ISA,
+// for vendored headers whose kernels can't be marked one by one. Include every header the rest of the binary shares
+// before the push, so their inline functions stay baseline, and keep registration after the pop. The region does not
+// define __AVX2__, so vendored code has to be told through its own config macros which path to take.
+#if defined(__clang__) && (defined(__x86_64__) || defined(__i386)) && !defined(BENCH_FORCE_SIMDE)
+#  define BENCH_PUSH_TARGET_AVX2 \
+      _Pragma("clang attribute push (__attribute__((target(\"avx2,bmi\"))), apply_to = function)")
+#  define BENCH_PUSH_TARGET_AVX2_BMI2 \
+      _Pragma("clang attribute push (__attribute__((target(\"avx2,bmi,bmi2\"))), apply_to = function)")
+#  define BENCH_POP_TARGET _Pragma("clang attribute pop")
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386)) && !defined(BENCH_FORCE_SIMDE)
+#  define BENCH_PUSH_TARGET_AVX2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,bmi\")")
+#  define BENCH_PUSH_TARGET_AVX2_BMI2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,bmi,bmi2\")")
+#  define BENCH_POP_TARGET _Pragma("GCC pop_options")
+#else
+#  define BENCH_PUSH_TARGET_AVX2
+#  define BENCH_PUSH_TARGET_AVX2_BMI2
+#  define BENCH_POP_TARGET
+#endif
+
+// Instruction set extensions a scanner kernel may require. See pattern_scanner::GetTraits.
+enum cpu_feature : uint32_t
+{
+    CPU_SSE2 = 1u << 0,
+    CPU_SSSE3 = 1u << 1,
+    CPU_SSE41 = 1u << 2,
+    CPU_SSE42 = 1u << 3,
+    CPU_AVX2 = 1u << 4,
+    CPU_BMI1 = 1u << 5,
+    CPU_BMI2 = 1u << 6,
+
+    CPU_ALL = (1u << 7) - 1,
+};
+
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)) && !defined(BENCH_FORCE_SIMDE)
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+inline void bench_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<uint32_t>(info[i]);
+}
+inline uint64_t bench_xgetbv0() { return _xgetbv(0); }
+#  else
+#    include <cpuid.h>
+inline void bench_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+inline uint64_t bench_xgetbv0() {
+    uint32_t lo, hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+#  endif
+
+// Queries cpuid once. AVX2 also requires the OS to save YMM state (OSXSAVE + XCR0).
+inline uint32_t DetectCpuFeatures()
+{
+    uint32_t regs[4] {};
+    bench_cpuid(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+
+    uint32_t features = 0;
+    bool os_ymm = false;
+
+    if (max_leaf >= 1)
+    {
+        bench_cpuid(1, 0, regs);
+
+        if (regs[3] & (1u << 26))
+            features |= CPU_SSE2;
+        if (regs[2] & (1u << 9))
+            features |= CPU_SSSE3;
+        if (regs[2] & (1u << 19))
+            features |= CPU_SSE41;
+        if (regs[2] & (1u << 20))
+            features |= CPU_SSE42;
+
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        const bool avx = (regs[2] & (1u << 28)) != 0;
+        os_ymm = osxsave && avx && ((bench_xgetbv0() & 0x6) == 0x6);
+    }
+
+    if (max_leaf >= 7)
+    {
+        bench_cpuid(7, 0, regs);
+
+        if ((regs[1] & (1u << 5)) && os_ymm)
+            features |= CPU_AVX2;
+        if (regs[1] & (1u << 3))
+            features |= CPU_BMI1;
+        if (regs[1] & (1u << 8))
+            features |= CPU_BMI2;
+    }
+
+    return features;
+}
+#else
+// Non-x86 and BENCH_FORCE_SIMDE builds go through SIMDE, which emulates every extension.
+inline uint32_t DetectCpuFeatures() { return CPU_ALL; }
+#endif
+
+inline std::string CpuFeatureNames(uint32_t features)
+{
+    static const struct
+    {
+        uint32_t bit;
+        const char* name;
+    } names[] = {
+        {CPU_SSE2, "sse2"},
+        {CPU_SSSE3, "ssse3"},
+        {CPU_SSE41, "sse4.1"},
+        {CPU_SSE42, "sse4.2"},
+        {CPU_AVX2, "avx2"},
+        {CPU_BMI1, "bmi1"},
+        {CPU_BMI2, "bmi2"},
+    };
+
+    std::string out;
+    for (const auto& entry : names)
+    {
+        if (features & entry.bit)
+        {
+            if (!out.empty())
+                out.push_back(' ');
+            out += entry.name;
+        }
+    }
+
+    return out.empty() ? "none" : out;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+// Multi-threaded adapter for any pattern_scanner (patterns/parallel.cpp), registered by --threads as
+// "parallel(<name>)".
+//
+// A scan is split into one slice per thread. Each slice owns a range of match starts and extends pattern length - 1
+// bytes past it, so matches that straddle a slice boundary are still found. The inner scanner runs on every slice on a
+// shared thread pool, and the hits are merged back in address order.
+
+#include "pattern_entry.h"
+
+namespace parallel_scanner
+{
+// Regions shorter than this per thread use fewer slices, so small scans are not dominated by the hand-off.
+static constexpr size_t default_min_slice = 64 * 1024;
+
+// Wraps inner, which the adapter then owns. threads counts the calling thread, which scans a slice too.
+std::unique_ptr<pattern_scanner> wrap(
+    std::unique_ptr<pattern_scanner> inner, size_t threads, size_t min_slice = default_min_slice);
+} // namespace parallel_scanner
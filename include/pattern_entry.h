@@ -26,32 +26,417 @@
 #include <memory>
 #include <vector>
 
+#include "cpu_features.h"
+
 using mem::byte;
 
+// What a scanner needs from the host and the buffer, checked by the harness before it is run.
+struct scanner_traits
+{
+    // cpu_feature bits the kernel was compiled for. Scanners whose bits the host lacks are not run.
+    uint32_t isa {0};
+
+    // Required alignment of the data pointer, in bytes (1 = any).
+    size_t alignment {1};
+
+    // Bytes the scanner may read outside [data, data + length). Reads never cross into another page.
+    size_t overread {0};
+
+    // Name of a registered scanner that implements the same algorithm without isa, if any.
+    const char* fallback {nullptr};
+
+    // ScanMany covers the whole set in one pass over the data, instead of one pass per pattern.
+    bool multi_pattern {false};
+};
+
+// Per-pattern state produced by pattern_scanner::Compile.
+// Scanners derive from this to cache their tables next to the raw pattern.
+//
+// Every byte has a bit mask: a data byte matches when (data & byte_mask[i]) == bytes[i].
+// 0xFF is an exact byte ('x'), 0x00 a full wildcard ('?'), anything else a partial (e.g. nibble or ModRM field)
+// wildcard. The mask string marks partial bytes as '?', so scanners that only understand 'x'/'?' see a superset.
+struct compiled_pattern
+{
+    std::vector<byte> bytes;
+    std::string mask;
+    std::vector<byte> byte_mask;
+
+    // Set when partial byte masks were widened to '?' for a scanner without native byte-mask support.
+    // pattern_scanner::ScanVerified then re-checks every hit against byte_mask.
+    bool widened {false};
+
+    compiled_pattern() = default;
+    compiled_pattern(const byte* pattern, const char* masks);
+    compiled_pattern(const byte* pattern, const byte* byte_masks, size_t length);
+
+    virtual ~compiled_pattern() = default;
+
+    const byte* pattern() const noexcept
+    {
+        return bytes.data();
+    }
+
+    const char* masks() const noexcept
+    {
+        return mask.c_str();
+    }
+
+    size_t size() const noexcept
+    {
+        return mask.size();
+    }
+
+    const byte* byte_masks() const noexcept
+    {
+        return byte_mask.data();
+    }
+
+    // Whether any byte is neither exact nor a full wildcard.
+    bool has_partial_masks() const noexcept;
+
+    // Checks one candidate against the full byte masks.
+    bool matches(const byte* candidate) const noexcept;
+};
+
+// One readable range of a scatter list, e.g. a committed section of a process image.
+struct scan_region
+{
+    const byte* data;
+    size_t length;
+};
+
+// A run of matches at consecutive offsets, as produced by match_bitmap::runs.
+struct match_run
+{
+    size_t offset;
+    size_t length;
+};
+
+// One bit per offset of a scanned region, set where a match starts. At 1 bit instead of one pointer per offset, this
+// is the compact form for regions where a large share of the offsets match.
+class match_bitmap
+{
+public:
+    // Clears the bitmap and sizes it for a region of length bytes.
+    void reset(size_t length)
+    {
+        length_ = length;
+        words_.assign((length + 63) / 64, 0);
+    }
+
+    size_t length() const noexcept
+    {
+        return length_;
+    }
+
+    void set(size_t offset) noexcept
+    {
+        words_[offset / 64] |= uint64_t(1) << (offset % 64);
+    }
+
+    bool test(size_t offset) const noexcept
+    {
+        return (words_[offset / 64] >> (offset % 64)) & 1;
+    }
+
+    // Bit i of words()[i / 64] is offset i.
+    uint64_t* words() noexcept
+    {
+        return words_.data();
+    }
+
+    const uint64_t* words() const noexcept
+    {
+        return words_.data();
+    }
+
+    size_t word_count() const noexcept
+    {
+        return words_.size();
+    }
+
+    // Number of set bits.
+    size_t count() const noexcept;
+
+    // Set bits as maximal runs of consecutive offsets, in ascending order.
+    std::vector<match_run> runs() const;
+
+    bool operator==(const match_bitmap& other) const noexcept
+    {
+        return length_ == other.length_ && words_ == other.words_;
+    }
+
+    bool operator!=(const match_bitmap& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+    size_t length_ {0};
+};
+
+// Receives matches from pattern_scanner::ScanInto.
+// Writes into a caller-owned buffer without allocating, appends to a vector, or sets bits in a match_bitmap.
+class match_sink
+{
+public:
+    // Fixed-capacity sink. The scan stops once it is full; pushing past that sets overflowed().
+    // A null results buffer only counts the matches.
+    match_sink(const byte** results, size_t capacity) noexcept
+        : results_(results)
+        , capacity_(capacity)
+    {}
+
+    // Growable sink, appends to an existing vector. Like the fixed sink, it stops the scan after max_results matches.
+    explicit match_sink(std::vector<const byte*>& results, size_t max_results = SIZE_MAX) noexcept
+        : vector_(&results)
+        , limit_(max_results)
+    {}
+
+    // Bitmap sink over the region starting at base, which the bitmap must already be sized for. Never fills up.
+    match_sink(match_bitmap& bitmap, const byte* base) noexcept
+        : bitmap_(&bitmap)
+        , bitmap_base_(base)
+    {}
+
+    // Records a match. Returns false when the scanner must stop.
+    bool push(const byte* result)
+    {
+        if ((reinterpret_cast<uintptr_t>(result) & align_mask_) != 0)
+            return true;
+
+        if (verify_ && !verify_->matches(result))
+            return true;
+
+        if (count_ < capacity_)
+        {
+            if (results_)
+                results_[count_] = result;
+            return ++count_ < capacity_;
+        }
+
+        if (bitmap_)
+        {
+            bitmap_->set(static_cast<size_t>(result - bitmap_base_));
+            ++count_;
+            return true;
+        }
+
+        if (vector_ && count_ < limit_)
+        {
+            vector_->push_back(result);
+            return ++count_ < limit_;
+        }
+
+        overflowed_ = true;
+        return false;
+    }
+
+    const byte* const* data() const noexcept
+    {
+        return vector_ ? vector_->data() : results_;
+    }
+
+    size_t size() const noexcept
+    {
+        return count_;
+    }
+
+    bool overflowed() const noexcept
+    {
+        return overflowed_;
+    }
+
+    // Whether the sink has reached its capacity or max_results, i.e. the last push() returned false.
+    bool full() const noexcept
+    {
+        if (bitmap_)
+            return false;
+
+        return vector_ ? (count_ >= limit_) : (count_ >= capacity_);
+    }
+
+    // Drops pushed candidates that do not match pattern's byte masks. Pass nullptr to stop checking.
+    void verify(const compiled_pattern* pattern) noexcept
+    {
+        verify_ = pattern;
+    }
+
+    // Drops pushed candidates whose address is not a multiple of alignment (a power of two). 1 accepts everything.
+    void align(size_t alignment) noexcept
+    {
+        align_mask_ = alignment - 1;
+    }
+
+    void clear() noexcept
+    {
+        count_ = 0;
+        overflowed_ = false;
+
+        if (vector_)
+            vector_->clear();
+
+        if (bitmap_)
+            bitmap_->reset(bitmap_->length());
+    }
+
+private:
+    const byte** results_ {nullptr};
+    size_t capacity_ {0};
+    size_t count_ {0};
+    bool overflowed_ {false};
+    std::vector<const byte*>* vector_ {nullptr};
+    size_t limit_ {0};
+    const compiled_pattern* verify_ {nullptr};
+    uintptr_t align_mask_ {0};
+    match_bitmap* bitmap_ {nullptr};
+    const byte* bitmap_base_ {nullptr};
+};
+
 struct pattern_scanner
 {
     uint64_t Elapsed {0};
     uint64_t ElapsedNs {0};
+    uint64_t CompileElapsedNs {0};
+    uint64_t SinkElapsed {0};
+    uint64_t SinkElapsedNs {0};
     size_t Failed {0};
 
     virtual ~pattern_scanner() = default;
 
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const = 0;
     virtual const char* GetName() const = 0;
+
+    // The default is a portable scanner: no ISA requirements, any alignment, no overread.
+    virtual scanner_traits GetTraits() const
+    {
+        return {};
+    }
+
+    // Two-stage API: Compile once, then Scan any number of regions.
+    // The default Compile keeps a copy of the pattern and mask.
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const;
+
+    // Compiles a pattern with per-byte bit masks. The default widens partial masks to '?', compiles that, and marks
+    // the result so ScanVerified filters the extra candidates. Scanners with native masked compares override this.
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const;
+
+    // Pushes every match, in ascending address order, into the sink.
+    // Implementations must return as soon as results.push() returns false.
+    virtual void ScanInto(
+        const compiled_pattern& compiled, const byte* data, size_t length, match_sink& results) const = 0;
+
+    // ScanInto, re-checking each hit against the byte masks when the pattern was widened.
+    // Callers holding a pattern from CompileMasked go through this rather than ScanInto.
+    void ScanVerified(const compiled_pattern& compiled, const byte* data, size_t length, match_sink& results) const;
+
+    // Only reports matches whose address is a multiple of alignment (1, 2, 4, ... 32), e.g. 16 for function prologues.
+    // Alignment 1 is ScanVerified. Otherwise the sink drops misaligned hits and ScanAlignedInto does the scan.
+    void ScanAligned(
+        const compiled_pattern& compiled, const byte* data, size_t length, size_t alignment, match_sink& results) const;
+    std::vector<const byte*> ScanAligned(
+        const compiled_pattern& compiled, const byte* data, size_t length, size_t alignment) const;
+
+    // The default is a plain ScanInto. Scanners that can skip unaligned positions override it.
+    virtual void ScanAlignedInto(
+        const compiled_pattern& compiled, const byte* data, size_t length, size_t alignment, match_sink& results) const;
+
+    // Sets bit i of results for every match at data + i, after resizing it to length. The default pushes the hits of
+    // ScanVerified into a bitmap sink. Dense kernels override it to write whole words of bits per step.
+    virtual void ScanBitmap(
+        const compiled_pattern& compiled, const byte* data, size_t length, match_bitmap& results) const;
+
+    // Returns the lowest match, or nullptr. The default stops ScanVerified after one result.
+    virtual const byte* ScanFirst(const compiled_pattern& compiled, const byte* data, size_t length) const;
+
+    // Counts matches, stopping the scan once max_results were found. CountMatches(..., 2) tells 0 / 1 / many apart
+    // without materialising every hit of a pattern that matches everywhere.
+    size_t CountMatches(const compiled_pattern& compiled, const byte* data, size_t length, size_t max_results) const;
+
+    // Collects the first max_results matches the scanner pushes, stopping the scan there. Bounds memory on flood inputs.
+    // They are the lowest ones only as far as the scanner keeps to ScanInto's ascending order; nothing re-sorts them.
+    std::vector<const byte*> ScanBounded(
+        const compiled_pattern& compiled, const byte* data, size_t length, size_t max_results) const;
+
+    // Convenience wrappers that collect the matches into a freshly allocated vector.
+    virtual std::vector<const byte*> Scan(const compiled_pattern& compiled, const byte* data, size_t length) const;
+    virtual std::vector<const byte*> Scan(
+        const byte* pattern, const char* mask, const byte* data, size_t length) const;
+
+    // Scans a list of disjoint regions, in order, with one compiled pattern. Matches never span two regions, so the
+    // memory between them (often unmapped) is never touched. The default calls ScanVerified once per region and stops
+    // when the sink is full; scanners with per-call setup can override it to pay that cost once per list.
+    virtual void ScanRegions(
+        const compiled_pattern& compiled, const scan_region* regions, size_t count, match_sink& results) const;
+    std::vector<const byte*> ScanRegions(const compiled_pattern& compiled, const scan_region* regions, size_t count) const;
+
+    // Scans one region for several patterns, returning one result list per pattern in input order.
+    // The default compiles and scans each pattern in turn; multi-pattern engines override it with a single pass.
+    virtual std::vector<std::vector<const byte*>> ScanMany(
+        const byte* const* patterns, const char* const* masks, size_t count, const byte* data, size_t length) const;
+};
+
+// Scans a stream that arrives in consecutive chunks with one scanner and compiled pattern.
+// The last (pattern length - 1) bytes are carried over, so matches that straddle a chunk boundary are still found.
+// Offsets are absolute, counted from the start of the stream.
+class stream_scanner
+{
+public:
+    stream_scanner(const pattern_scanner& scanner, const compiled_pattern& pattern);
+
+    // Scans the next chunk and appends its matches, in ascending order, to offsets.
+    void Feed(const byte* chunk, size_t length, std::vector<size_t>& offsets);
+
+    // Starts a new stream at offset 0.
+    void Reset() noexcept;
+
+    // Absolute offset of the next chunk.
+    size_t Position() const noexcept
+    {
+        return position_;
+    }
+
+private:
+    const pattern_scanner& scanner_;
+    const compiled_pattern& pattern_;
+
+    // Tail of the previous chunks, followed by the head of the current chunk while it is being scanned.
+    std::vector<byte> seam_;
+    size_t carry_ {0};
+
+    std::vector<const byte*> hits_;
+    size_t position_ {0};
 };
 
 extern std::vector<std::unique_ptr<pattern_scanner>> PATTERN_SCANNERS;
 
-#define REGISTER_PATTERN__(CLASS, LINE)                    \
-    static mem::init_function DO_REGISTER_PATTERN_##LINE   \
-    {                                                      \
-        [] { PATTERN_SCANNERS.emplace_back(new CLASS()); } \
+// Constructors of every registered scanner. Unlike PATTERN_SCANNERS, --filter and CPU dispatch never trim this list,
+// so scanners built on top of others can still create them.
+extern std::vector<pattern_scanner* (*)()> PATTERN_FACTORIES;
+
+// A new instance of the registered scanner with this name, or nullptr if there is none.
+std::unique_ptr<pattern_scanner> CreatePatternScanner(const char* name);
+
+#define REGISTER_PATTERN__(CLASS, LINE)                                                       \
+    static mem::init_function DO_REGISTER_PATTERN_##LINE                                      \
+    {                                                                                         \
+        [] {                                                                                  \
+            PATTERN_SCANNERS.emplace_back(new CLASS());                                       \
+            PATTERN_FACTORIES.emplace_back([]() -> pattern_scanner* { return new CLASS(); }); \
+        }                                                                                     \
     }
 #define REGISTER_PATTERN_(CLASS, LINE) REGISTER_PATTERN__(CLASS, LINE)
 #define REGISTER_PATTERN(CLASS) REGISTER_PATTERN_(CLASS, __LINE__)
 
 std::vector<const byte*> FindPatternSimple(const byte* data, size_t length, const byte* pattern, const char* masks);
+void FindPatternSimple(const byte* data, size_t length, const byte* pattern, const char* masks, match_sink& results);
+
+// Byte-mask form: matches where (data[i] & byte_masks[i]) == (pattern[i] & byte_masks[i]).
+std::vector<const byte*> FindPatternSimple(
+    const byte* data, size_t length, const byte* pattern, const byte* byte_masks, size_t pattern_length);
+void FindPatternSimple(const byte* data, size_t length, const byte* pattern, const byte* byte_masks,
+    size_t pattern_length, match_sink& results);
 
 std::string MakeCompactHexPattern(const byte* pattern, const char* mask);
 std::string MakeSpacedHexPattern(const byte* pattern, const char* mask, bool single_wildcard_token);
\ No newline at end of file
@@ -7,10 +7,14 @@
 #  if defined(_MSC_VER)
 #    include <intrin.h>
 #    pragma intrinsic(__rdtsc)
+inline uint64_t bench_rdtsc() { return __rdtsc(); }
+#  elif defined(BENCH_FORCE_SIMDE)
+// <x86intrin.h> would pull the native intrinsic types in next to SIMDE's.
+inline uint64_t bench_rdtsc() { return __builtin_ia32_rdtsc(); }
 #  else
 #    include <x86intrin.h>
-#  endif
 inline uint64_t bench_rdtsc() { return __rdtsc(); }
+#  endif
 #elif defined(__aarch64__) || defined(_M_ARM64)
 #  if defined(__APPLE__)
 #    include <mach/mach_time.h>
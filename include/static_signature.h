@@ -0,0 +1,314 @@
+#pragma once
+
+// Signatures that are known when the program is built.
+//
+// static_signature<"48 8B ?? ?? E8"> parses its literal in a consteval context. Hex pairs are exact bytes, '?' or '??'
+// are wildcards, and '4?' / '?8' are nibble wildcards. A malformed literal does not compile. The anchor byte, the
+// split into masked 1/2/4/8-byte compares, and the verification itself are all fixed at compile time. At run time
+// only memchr over the anchor and one unrolled compare chain per candidate are left.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace static_signature_impl
+{
+template <size_t N>
+struct literal
+{
+    char text[N] {};
+
+    consteval literal(const char (&s)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            text[i] = s[i];
+    }
+};
+
+consteval int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+template <size_t M>
+struct layout
+{
+    std::array<byte, M> bytes {}; // Already masked.
+    std::array<byte, M> masks {};
+};
+
+// Parses into out when given one, and returns the byte count either way.
+template <size_t M>
+consteval size_t parse(const char* text, layout<M>* out)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; text[i];)
+    {
+        if (text[i] == ' ')
+        {
+            ++i;
+            continue;
+        }
+
+        size_t len = 0;
+        while (text[i + len] && text[i + len] != ' ')
+            ++len;
+
+        byte value = 0;
+        byte mask = 0;
+
+        if (len == 1 && text[i] == '?')
+        {
+        }
+        else if (len == 2)
+        {
+            for (size_t k = 0; k < 2; ++k)
+            {
+                const int shift = k ? 0 : 4;
+                if (text[i + k] == '?')
+                    continue;
+
+                const int digit = hex_digit(text[i + k]);
+                if (digit < 0)
+                    throw "static_signature: bad hex digit";
+
+                value |= static_cast<byte>(digit << shift);
+                mask |= static_cast<byte>(0xF << shift);
+            }
+        }
+        else
+        {
+            throw "static_signature: tokens are two hex digits (either may be '?') or a lone '?'";
+        }
+
+        if (out)
+        {
+            out->bytes[count] = value;
+            out->masks[count] = mask;
+        }
+
+        ++count;
+        i += len;
+    }
+
+    if (count == 0)
+        throw "static_signature: empty signature";
+
+    return count;
+}
+
+// One masked compare of 1, 2, 4 or 8 bytes.
+struct chunk
+{
+    size_t offset {0};
+    size_t width {0};
+    uint64_t value {0};
+    uint64_t mask {0};
+};
+
+// Covers every non-wildcard byte with as few chunks as possible. Returns the chunk count and fills out when given one.
+template <size_t M>
+consteval size_t split(const layout<M>& sig, chunk* out)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < M;)
+    {
+        if (sig.masks[i] == 0)
+        {
+            ++i;
+            continue;
+        }
+
+        // The span up to the last non-wildcard byte within 8 bytes of i.
+        size_t span = 1;
+        for (size_t j = 1; j < 8 && i + j < M; ++j)
+        {
+            if (sig.masks[i + j])
+                span = j + 1;
+        }
+
+        size_t width = 8;
+        while (width / 2 >= span)
+            width /= 2;
+
+        // Patterns shorter than the chunk take the widest one that fits and leave the rest to the next chunk.
+        if (width > M)
+        {
+            width /= 2;
+            span = width;
+        }
+
+        // Near the end, a wide chunk slides back over bytes that are already covered, instead of splitting in two.
+        const size_t offset = (i + width <= M) ? i : (M - width);
+
+        if (out)
+        {
+            chunk c {offset, width, 0, 0};
+            for (size_t k = 0; k < width; ++k)
+            {
+                const size_t at = offset + k;
+                if (at < i)
+                    continue;
+
+                c.value |= uint64_t(sig.bytes[at]) << (8 * k);
+                c.mask |= uint64_t(sig.masks[at]) << (8 * k);
+            }
+            out[count] = c;
+        }
+
+        ++count;
+        i += span;
+    }
+
+    return count;
+}
+
+template <size_t M, size_t C>
+consteval std::array<chunk, C> make_chunks(const layout<M>& sig)
+{
+    std::array<chunk, C> chunks {};
+    split(sig, chunks.data());
+    return chunks;
+}
+
+template <size_t M>
+consteval layout<M> make_layout(const char* text)
+{
+    layout<M> sig {};
+    parse(text, &sig);
+    return sig;
+}
+
+// The rarest exact byte, preferring later positions on ties, or M when there is none.
+template <size_t M>
+consteval size_t pick_anchor(const layout<M>& sig)
+{
+    size_t anchor = M;
+
+    for (size_t i = 0; i < M; ++i)
+    {
+        if (sig.masks[i] != 0xFF)
+            continue;
+
+        if (anchor == M || commonness(sig.bytes[i]) <= commonness(sig.bytes[anchor]))
+            anchor = i;
+    }
+
+    return anchor;
+}
+} // namespace static_signature_impl
+
+template <static_signature_impl::literal Text>
+struct static_signature
+{
+    static constexpr const char* text = Text.text;
+    static constexpr size_t length = static_signature_impl::parse<1>(Text.text, nullptr);
+    static constexpr static_signature_impl::layout<length> layout =
+        static_signature_impl::make_layout<length>(Text.text);
+
+    static constexpr size_t anchor = static_signature_impl::pick_anchor(layout);
+
+    static constexpr size_t chunk_count = static_signature_impl::split(layout, nullptr);
+    static constexpr std::array<static_signature_impl::chunk, chunk_count> chunks =
+        static_signature_impl::make_chunks<length, chunk_count>(layout);
+
+    template <size_t I>
+    static bool check(const byte* candidate) noexcept
+    {
+        constexpr static_signature_impl::chunk c = chunks[I];
+
+        if constexpr (c.width == 8)
+        {
+            uint64_t v;
+            std::memcpy(&v, candidate + c.offset, sizeof(v));
+            return (v & c.mask) == c.value;
+        }
+        else if constexpr (c.width == 4)
+        {
+            uint32_t v;
+            std::memcpy(&v, candidate + c.offset, sizeof(v));
+            return (v & static_cast<uint32_t>(c.mask)) == static_cast<uint32_t>(c.value);
+        }
+        else if constexpr (c.width == 2)
+        {
+            uint16_t v;
+            std::memcpy(&v, candidate + c.offset, sizeof(v));
+            return static_cast<uint16_t>(v & c.mask) == static_cast<uint16_t>(c.value);
+        }
+        else if constexpr (c.mask == 0xFF)
+        {
+            return candidate[c.offset] == static_cast<byte>(c.value);
+        }
+        else
+        {
+            return (candidate[c.offset] & static_cast<byte>(c.mask)) == static_cast<byte>(c.value);
+        }
+    }
+
+    template <size_t... I>
+    static bool check_all(const byte* candidate, std::index_sequence<I...>) noexcept
+    {
+        return (check<I>(candidate) && ...);
+    }
+
+    // The candidate must have length readable bytes.
+    static bool matches(const byte* candidate) noexcept
+    {
+        return check_all(candidate, std::make_index_sequence<chunk_count> {});
+    }
+
+    static void scan(const byte* data, size_t size, match_sink& results)
+    {
+        if (size < length)
+            return;
+
+        const byte* const last = data + (size - length);
+
+        if constexpr (anchor == length)
+        {
+            for (const byte* candidate = data; candidate <= last; ++candidate)
+            {
+                if (matches(candidate) && !results.push(candidate))
+                    return;
+            }
+        }
+        else
+        {
+            const byte* cursor = data + anchor;
+            const byte* const end = last + anchor + 1;
+
+            while (cursor < end)
+            {
+                cursor = static_cast<const byte*>(std::memchr(cursor, layout.bytes[anchor], size_t(end - cursor)));
+                if (!cursor)
+                    return;
+
+                const byte* candidate = cursor - anchor;
+                if (matches(candidate) && !results.push(candidate))
+                    return;
+
+                ++cursor;
+            }
+        }
+    }
+
+    static const byte* find_first(const byte* data, size_t size)
+    {
+        const byte* first = nullptr;
+        match_sink sink(&first, 1);
+        scan(data, size, sink);
+        return first;
+    }
+};
@@ -0,0 +1,377 @@
+// Aho-Corasick over the exact runs of masked patterns.
+//
+// One maximal run of 0xFF mask bytes from each pattern becomes a keyword of one automaton: the rarest in a sample of
+// the data, or the longest when there is no data yet. When a keyword ends in
+// the data, it fixes the pattern start, and the position-constraint verifier checks the other runs at their offsets
+// from it, then any partial mask bytes. Each keyword hit costs at most one pattern length, whatever the data looks like.
+// Shallow states, which nearly every step visits, keep a full 256-entry row. Deeper states keep a sorted edge list and
+// a failure link, so the automaton stays compact and the scan stays linear in the data.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace aho_corasick_impl
+{
+// At most 256 full rows (256 KiB), taken in breadth-first order.
+static constexpr uint32_t max_dense_states = 256;
+
+struct keyword_ref
+{
+    uint32_t pattern;    // Index into automaton::patterns.
+    uint32_t end_offset; // Offset of the keyword's last byte in the pattern.
+    uint64_t head_value; // The first 8 pattern bytes, masked, so most misses never touch the pattern.
+    uint64_t head_mask;
+};
+
+struct exact_run
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct stored_pattern
+{
+    uint32_t id;
+    uint32_t length;
+    std::vector<byte> values;
+    std::vector<byte> masks;
+    std::vector<exact_run> runs;   // Every exact run except the keyword.
+    std::vector<uint32_t> partial; // Offsets whose mask is neither 0xFF nor 0x00.
+
+    bool verify(const byte* candidate) const
+    {
+        for (const exact_run& run : runs)
+        {
+            if (std::memcmp(candidate + run.offset, values.data() + run.offset, run.length) != 0)
+                return false;
+        }
+
+        for (uint32_t offset : partial)
+        {
+            if (((candidate[offset] ^ values[offset]) & masks[offset]) != 0)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+struct automaton
+{
+    std::vector<stored_pattern> patterns;
+    std::vector<stored_pattern> unanchored; // No exact byte, checked at every position.
+
+    uint32_t dense_count {0};
+    std::vector<uint32_t> dense; // dense_count rows of 256 next states.
+
+    std::vector<uint32_t> fail;
+    std::vector<uint32_t> edge_begin; // State s has edges [edge_begin[s], edge_begin[s + 1]).
+    std::vector<byte> edge_bytes;
+    std::vector<uint32_t> edge_targets;
+
+    std::vector<uint32_t> output_begin; // State s reports outputs [output_begin[s], output_begin[s + 1]).
+    std::vector<keyword_ref> outputs;
+
+    // Adds a pattern with per-byte masks. Only 0xFF bytes can be part of the keyword.
+    void add(uint32_t id, const byte* pattern, const byte* byte_masks, size_t length, const byte_sample& sample)
+    {
+        stored_pattern stored;
+        stored.id = id;
+        stored.length = static_cast<uint32_t>(length);
+        stored.values.resize(length);
+        stored.masks.assign(byte_masks, byte_masks + length);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            stored.values[i] = pattern[i] & byte_masks[i];
+
+            if (byte_masks[i] != 0xFF && byte_masks[i] != 0x00)
+                stored.partial.push_back(static_cast<uint32_t>(i));
+        }
+
+        for (size_t i = 0; i < length;)
+        {
+            if (byte_masks[i] != 0xFF)
+            {
+                ++i;
+                continue;
+            }
+
+            const size_t begin = i;
+            while (i < length && byte_masks[i] == 0xFF)
+                ++i;
+
+            stored.runs.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(i - begin)});
+        }
+
+        if (stored.runs.empty())
+        {
+            unanchored.push_back(std::move(stored));
+            return;
+        }
+
+        auto score = [&](const exact_run& run) {
+            double sum = 0.0;
+            for (uint32_t j = run.offset; j < run.offset + run.length; ++j)
+                sum += sample.log_share[pattern[j]];
+            return sum;
+        };
+
+        const auto key = std::min_element(stored.runs.begin(), stored.runs.end(),
+            [&](const exact_run& lhs, const exact_run& rhs) { return score(lhs) < score(rhs); });
+
+        uint32_t state = 0;
+        for (uint32_t j = key->offset; j < key->offset + key->length; ++j)
+            state = insert(state, pattern[j]);
+
+        keyword_ref ref {static_cast<uint32_t>(patterns.size()), key->offset + key->length - 1, 0, 0};
+        for (size_t j = 0; j < (std::min)(length, size_t(8)); ++j)
+        {
+            ref.head_value |= uint64_t(pattern[j] & byte_masks[j]) << (8 * j);
+            ref.head_mask |= uint64_t(byte_masks[j]) << (8 * j);
+        }
+
+        trie_outputs_[state].push_back(ref);
+        stored.runs.erase(key);
+        patterns.push_back(std::move(stored));
+    }
+
+    // Lays out the trie breadth-first, computes failure links and merges outputs along them.
+    void build()
+    {
+        const size_t state_count = trie_.size();
+
+        std::vector<uint32_t> order {0};
+        std::vector<uint32_t> renumber(state_count, 0);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            renumber[order[i]] = static_cast<uint32_t>(i);
+            for (const auto& edge : trie_[order[i]])
+                order.push_back(edge.second);
+        }
+
+        dense_count = static_cast<uint32_t>((std::min)(state_count, size_t(max_dense_states)));
+        fail.assign(state_count, 0);
+        edge_begin.assign(state_count + 1, 0);
+        output_begin.assign(state_count + 1, 0);
+        dense.assign(size_t(dense_count) * 256, 0);
+
+        for (size_t i = 0; i < state_count; ++i)
+        {
+            const std::vector<std::pair<byte, uint32_t>>& edges = trie_[order[i]];
+            edge_begin[i + 1] = edge_begin[i] + static_cast<uint32_t>(edges.size());
+
+            for (const auto& edge : edges)
+            {
+                edge_bytes.push_back(edge.first);
+                edge_targets.push_back(renumber[edge.second]);
+            }
+        }
+
+        // Breadth-first order means every failure link, and every row it needs, is already done.
+        std::vector<std::vector<keyword_ref>> state_outputs(state_count);
+        for (uint32_t s = 0; s < state_count; ++s)
+        {
+            state_outputs[s] = std::move(trie_outputs_[order[s]]);
+            if (s != 0)
+            {
+                const std::vector<keyword_ref>& inherited = state_outputs[fail[s]];
+                state_outputs[s].insert(state_outputs[s].end(), inherited.begin(), inherited.end());
+            }
+
+            for (uint32_t e = edge_begin[s]; e < edge_begin[s + 1]; ++e)
+                fail[edge_targets[e]] = (s == 0) ? 0 : step(fail[s], edge_bytes[e]);
+
+            if (s < dense_count)
+            {
+                uint32_t* row = &dense[size_t(s) * 256];
+                for (size_t c = 0; c < 256; ++c)
+                    row[c] = (s == 0) ? 0 : dense[size_t(fail[s]) * 256 + c];
+
+                for (uint32_t e = edge_begin[s]; e < edge_begin[s + 1]; ++e)
+                    row[edge_bytes[e]] = edge_targets[e];
+            }
+        }
+
+        for (uint32_t s = 0; s < state_count; ++s)
+        {
+            output_begin[s + 1] = output_begin[s] + static_cast<uint32_t>(state_outputs[s].size());
+            outputs.insert(outputs.end(), state_outputs[s].begin(), state_outputs[s].end());
+        }
+
+        trie_.clear();
+        trie_outputs_.clear();
+    }
+
+    uint32_t step(uint32_t state, byte value) const
+    {
+        while (state >= dense_count)
+        {
+            const byte* first = edge_bytes.data() + edge_begin[state];
+            const byte* last = edge_bytes.data() + edge_begin[state + 1];
+            const byte* found = std::lower_bound(first, last, value);
+
+            if (found != last && *found == value)
+                return edge_targets[found - edge_bytes.data()];
+
+            state = fail[state];
+        }
+
+        return dense[size_t(state) * 256 + value];
+    }
+
+private:
+    // Trie under construction, with edges sorted by byte.
+    std::vector<std::vector<std::pair<byte, uint32_t>>> trie_ {{}};
+    std::vector<std::vector<keyword_ref>> trie_outputs_ {{}};
+
+    uint32_t insert(uint32_t state, byte value)
+    {
+        std::vector<std::pair<byte, uint32_t>>& edges = trie_[state];
+        auto found = std::lower_bound(edges.begin(), edges.end(), value,
+            [](const std::pair<byte, uint32_t>& edge, byte v) { return edge.first < v; });
+
+        if (found != edges.end() && found->first == value)
+            return found->second;
+
+        const uint32_t next = static_cast<uint32_t>(trie_.size());
+        edges.insert(found, {value, next});
+        trie_.emplace_back();
+        trie_outputs_.emplace_back();
+        return next;
+    }
+};
+
+// Report(id, match) returns false to stop the scan.
+template <typename Report>
+static void scan(const automaton& a, const byte* data, size_t length, Report& report)
+{
+    uint32_t state = 0;
+
+    for (size_t pos = 0; pos < length; ++pos)
+    {
+        for (const stored_pattern& p : a.unanchored)
+        {
+            if (p.length <= length - pos && p.verify(data + pos) && !report(p.id, data + pos))
+                return;
+        }
+
+        state = a.step(state, data[pos]);
+
+        for (uint32_t o = a.output_begin[state]; o < a.output_begin[state + 1]; ++o)
+        {
+            const keyword_ref& ref = a.outputs[o];
+            if (pos < ref.end_offset)
+                continue;
+
+            const size_t start = pos - ref.end_offset;
+            if (length - start >= 8)
+            {
+                uint64_t head;
+                std::memcpy(&head, data + start, sizeof(head));
+
+                if (((head ^ ref.head_value) & ref.head_mask) != 0)
+                    continue;
+            }
+
+            const stored_pattern& p = a.patterns[ref.pattern];
+
+            if (p.length > length - start || !p.verify(data + start))
+                continue;
+
+            if (!report(p.id, data + start))
+                return;
+        }
+    }
+}
+
+struct compiled_aho_corasick : compiled_pattern
+{
+    automaton machine;
+
+    compiled_aho_corasick(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        machine.add(0, bytes.data(), byte_mask.data(), size(), byte_sample());
+        machine.build();
+    }
+
+    compiled_aho_corasick(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        machine.add(0, bytes.data(), byte_mask.data(), size(), byte_sample());
+        machine.build();
+    }
+};
+} // namespace aho_corasick_impl
+
+struct aho_corasick_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<aho_corasick_impl::compiled_aho_corasick>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<aho_corasick_impl::compiled_aho_corasick>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        auto report = [&results](uint32_t, const byte* match) { return results.push(match); };
+
+        aho_corasick_impl::scan(
+            static_cast<const aho_corasick_impl::compiled_aho_corasick&>(pattern).machine, data, length, report);
+    }
+
+    // Builds one automaton for the whole set and sweeps the data once.
+    virtual std::vector<std::vector<const byte*>> ScanMany(const byte* const* patterns, const char* const* masks,
+        size_t count, const byte* data, size_t length) const override
+    {
+        std::vector<std::vector<const byte*>> results(count);
+        auto report = [&results](uint32_t id, const byte* match) {
+            results[id].push_back(match);
+            return true;
+        };
+
+        const byte_sample sample(data, length);
+        aho_corasick_impl::automaton machine;
+        std::vector<byte> byte_masks;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t pattern_length = std::strlen(masks[i]);
+            byte_masks.resize(pattern_length);
+            for (size_t j = 0; j < pattern_length; ++j)
+                byte_masks[j] = (masks[i][j] == 'x') ? 0xFF : 0x00;
+
+            machine.add(static_cast<uint32_t>(i), patterns[i], byte_masks.data(), pattern_length, sample);
+        }
+
+        machine.build();
+        aho_corasick_impl::scan(machine, data, length, report);
+
+        return results;
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.multi_pattern = true};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Aho-Corasick";
+    }
+};
+
+REGISTER_PATTERN(aho_corasick_pattern_scanner);
@@ -0,0 +1,379 @@
+// Picks an engine per call from a calibrated decision table. See include/auto_scanner.h.
+//
+// Each compiled pattern holds a compiled form for every engine its table cells can select, so a call only samples the
+// data for the anchor share and forwards to the chosen engine.
+
+#include "auto_scanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace auto_scanner
+{
+// The portable engine last, since it stands in for any engine the host cannot run.
+static const char* const engine_names[] = {
+    "Pattern16",
+    "Window Horspool (AVX2)",
+    "JIT (x86-64)",
+    "Can (AVX2)",
+    "dynamic_freq_scanner",
+    "mem::simd_scanner",
+    "SWAR (64-bit)",
+};
+
+static constexpr size_t engines = sizeof(engine_names) / sizeof(engine_names[0]);
+static constexpr uint8_t portable_engine = engines - 1;
+
+// Row per length x density x run bucket. Columns: anchor share < 0.2%, < 2%, >= 2%, each for regions < 256 KiB and
+// >= 256 KiB. Fitted by --calibrate_auto (4 MiB, 16 tests) on an AVX2 host. Cells no calibration call reached run
+// Pattern16.
+static constexpr decision_table default_table {{
+    // length <= 12
+    0, 3, 3, 2, 0, 0, // wildcards <= 15%, run < 4
+    0, 0, 0, 0, 2, 2, // wildcards <= 15%, run >= 4
+    0, 2, 0, 0, 0, 2, // wildcards > 15%, run < 4
+    0, 0, 0, 2, 2, 2, // wildcards > 15%, run >= 4
+    // length <= 32
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 2, 0, 2, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    // length <= 128
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    // length > 128
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+}};
+
+static decision_table current_table = default_table;
+
+size_t engine_count()
+{
+    return engines;
+}
+
+const char* engine_name(size_t engine)
+{
+    return engine_names[engine];
+}
+
+std::unique_ptr<pattern_scanner> create_engine(size_t engine)
+{
+    const uint32_t host = DetectCpuFeatures();
+
+    std::unique_ptr<pattern_scanner> scanner = CreatePatternScanner(engine_names[engine]);
+    if (!scanner)
+        return nullptr;
+
+    const scanner_traits traits = scanner->GetTraits();
+    if ((traits.isa & ~host) == 0)
+        return scanner;
+
+    if (!traits.fallback)
+        return nullptr;
+
+    scanner = CreatePatternScanner(traits.fallback);
+    if (scanner && (scanner->GetTraits().isa & ~host) == 0)
+        return scanner;
+
+    return nullptr;
+}
+
+// One instance per engine, shared by every Auto pattern. Engines the host cannot run are null.
+static const std::vector<std::unique_ptr<pattern_scanner>>& engine_instances()
+{
+    static const std::vector<std::unique_ptr<pattern_scanner>> instances = [] {
+        std::vector<std::unique_ptr<pattern_scanner>> out;
+        for (size_t i = 0; i < engines; ++i)
+            out.push_back(create_engine(i));
+        return out;
+    }();
+
+    return instances;
+}
+
+static uint8_t runnable(uint8_t engine)
+{
+    return engine_instances()[engine] ? engine : portable_engine;
+}
+
+// Share of the rarest of the given bytes in a sample of the data: 64-byte blocks, evenly spaced, about 1/64 of the
+// region and between 256 bytes and 4 KiB in total.
+static double rarest_share(const std::vector<byte>& exact, const byte* data, size_t length)
+{
+    if (exact.empty() || length == 0)
+        return 1.0;
+
+    uint32_t counts[256] {};
+    size_t total = 0;
+
+    const size_t sample = std::clamp(length / 64, size_t(256), size_t(4096));
+    if (sample >= length)
+    {
+        for (size_t i = 0; i < length; ++i)
+            ++counts[data[i]];
+        total = length;
+    }
+    else
+    {
+        const size_t blocks = sample / 64;
+        const size_t stride = (length - 64) / blocks;
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            const byte* block = data + b * stride;
+            for (size_t i = 0; i < 64; ++i)
+                ++counts[block[i]];
+        }
+        total = blocks * 64;
+    }
+
+    uint32_t rarest = UINT32_MAX;
+    for (byte value : exact)
+        rarest = (std::min)(rarest, counts[value]);
+
+    return double(rarest) / double(total);
+}
+
+static features shape_of(const compiled_pattern& pattern)
+{
+    features f;
+    f.length = pattern.size();
+
+    size_t wildcards = 0;
+    size_t run = 0;
+    for (byte mask : pattern.byte_mask)
+    {
+        if (mask == 0)
+            ++wildcards;
+
+        run = (mask == 0xFF) ? (run + 1) : 0;
+        f.longest_run = (std::max)(f.longest_run, run);
+    }
+
+    f.wildcard_density = f.length ? double(wildcards) / double(f.length) : 0.0;
+    return f;
+}
+
+static std::vector<byte> exact_bytes(const compiled_pattern& pattern)
+{
+    bool seen[256] {};
+    std::vector<byte> out;
+
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        if (pattern.byte_mask[i] == 0xFF && !seen[pattern.bytes[i]])
+        {
+            seen[pattern.bytes[i]] = true;
+            out.push_back(pattern.bytes[i]);
+        }
+    }
+
+    return out;
+}
+
+features measure(const compiled_pattern& pattern, const byte* data, size_t length)
+{
+    features f = shape_of(pattern);
+    f.anchor_share = rarest_share(exact_bytes(pattern), data, length);
+    f.region_size = length;
+    return f;
+}
+
+// The first of the six cells that share this pattern's length, density and run buckets.
+static size_t shape_cell(const features& f)
+{
+    const size_t length = (f.length <= 12) ? 0 : (f.length <= 32) ? 1 : (f.length <= 128) ? 2 : 3;
+    const size_t density = (f.wildcard_density <= 0.15) ? 0 : 1;
+    const size_t run = (f.longest_run < 4) ? 0 : 1;
+
+    return ((length * 2 + density) * 2 + run) * 6;
+}
+
+size_t cell_of(const features& f)
+{
+    const size_t share = (f.anchor_share < 0.002) ? 0 : (f.anchor_share < 0.02) ? 1 : 2;
+    const size_t size = (f.region_size < 256 * 1024) ? 0 : 1;
+
+    return shape_cell(f) + share * 2 + size;
+}
+
+std::string describe_cell(size_t cell)
+{
+    static const char* const lengths[] = {"len <= 12", "len <= 32", "len <= 128", "len > 128"};
+    static const char* const densities[] = {"wc <= 15%", "wc > 15%"};
+    static const char* const runs[] = {"run < 4", "run >= 4"};
+    static const char* const shares[] = {"share < 0.2%", "share < 2%", "share >= 2%"};
+    static const char* const sizes[] = {"size < 256K", "size >= 256K"};
+
+    const size_t size = cell % 2;
+    const size_t share = (cell / 2) % 3;
+    const size_t run = (cell / 6) % 2;
+    const size_t density = (cell / 12) % 2;
+    const size_t length = cell / 24;
+
+    return std::string(lengths[length]) + ", " + densities[density] + ", " + runs[run] + ", " + shares[share] + ", " +
+        sizes[size];
+}
+
+const decision_table& table()
+{
+    return current_table;
+}
+
+void set_table(const decision_table& cells)
+{
+    current_table = cells;
+}
+
+bool load_table(const char* path, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    decision_table cells = current_table;
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number)
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream in(line);
+        size_t cell = 0;
+        std::string name;
+        if (!(in >> cell) || !std::getline(in >> std::ws, name) || cell >= cell_count)
+        {
+            error = "bad line " + std::to_string(line_number);
+            return false;
+        }
+
+        size_t engine = 0;
+        while (engine < engines && name != engine_names[engine])
+            ++engine;
+
+        if (engine == engines)
+        {
+            error = "unknown engine '" + name + "' on line " + std::to_string(line_number);
+            return false;
+        }
+
+        cells[cell] = static_cast<uint8_t>(engine);
+    }
+
+    current_table = cells;
+    return true;
+}
+
+bool save_table(const char* path, const decision_table& cells)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file << "# pattern-bench Auto decision table: <cell> <engine>\n";
+    for (size_t cell = 0; cell < cell_count; ++cell)
+        file << "# " << describe_cell(cell) << "\n" << cell << " " << engine_names[cells[cell]] << "\n";
+
+    return static_cast<bool>(file);
+}
+
+struct compiled_auto : compiled_pattern
+{
+    size_t shape {0};
+    std::vector<byte> exact;
+    std::unique_ptr<compiled_pattern> forms[engines];
+
+    compiled_auto(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init([&](const pattern_scanner& engine) { return engine.Compile(pattern, mask); });
+    }
+
+    compiled_auto(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init([&](const pattern_scanner& engine) { return engine.CompileMasked(pattern, byte_masks, length); });
+    }
+
+    template <typename Compile>
+    void init(Compile&& compile)
+    {
+        shape = shape_cell(shape_of(*this));
+        exact = exact_bytes(*this);
+
+        // Only the engines this pattern's six cells can pick.
+        for (size_t i = 0; i < 6; ++i)
+        {
+            const uint8_t engine = runnable(current_table[shape + i]);
+            if (!forms[engine])
+                forms[engine] = compile(*engine_instances()[engine]);
+        }
+    }
+
+    // The engine for a call over length bytes at data. Falls back to any compiled form if the table changed since.
+    uint8_t pick(const byte* data, size_t length) const
+    {
+        const size_t share = [&] {
+            const double s = rarest_share(exact, data, length);
+            return (s < 0.002) ? 0 : (s < 0.02) ? 1 : 2;
+        }();
+        const size_t size = (length < 256 * 1024) ? 0 : 1;
+
+        uint8_t engine = runnable(current_table[shape + share * 2 + size]);
+        for (uint8_t i = 0; !forms[engine] && i < engines; ++i)
+            engine = i;
+
+        return engine;
+    }
+};
+} // namespace auto_scanner
+
+struct auto_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<auto_scanner::compiled_auto>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<auto_scanner::compiled_auto>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const auto& compiled = static_cast<const auto_scanner::compiled_auto&>(pattern);
+        const uint8_t engine = compiled.pick(data, length);
+
+        auto_scanner::engine_instances()[engine]->ScanVerified(*compiled.forms[engine], data, length, results);
+    }
+
+    virtual void ScanAlignedInto(const compiled_pattern& pattern, const byte* data, size_t length, size_t alignment,
+        match_sink& results) const override
+    {
+        const auto& compiled = static_cast<const auto_scanner::compiled_auto&>(pattern);
+        const uint8_t engine = compiled.pick(data, length);
+
+        auto_scanner::engine_instances()[engine]->ScanAligned(
+            *compiled.forms[engine], data, length, alignment, results);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Auto (cost model)";
+    }
+};
+
+REGISTER_PATTERN(auto_pattern_scanner);
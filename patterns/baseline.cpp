@@ -21,10 +21,10 @@
 
 struct simple_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return FindPatternSimple(data, length, pattern, mask);
+        FindPatternSimple(data, length, pattern.pattern(), pattern.masks(), results);
     }
 
     virtual const char* GetName() const override
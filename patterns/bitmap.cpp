@@ -0,0 +1,178 @@
+// Dense-match kernel that produces a bit per candidate offset.
+//
+// Each step tests 32 consecutive candidates at once. For every non-wildcard pattern byte, the 32 data bytes at that
+// offset are masked and compared, and the results are ANDed together. The movemask of the result is the match bits of
+// the 32 candidates, so ScanBitmap stores it as is, and no per-match work is done. The most selective bytes are
+// compared first, and a step ends early once no candidate is left, which keeps sparse data cheap as well.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <immintrin.h>
+#include <vector>
+
+namespace bitmap_impl
+{
+// One masked byte compare, at a pattern offset.
+struct byte_check
+{
+    size_t offset;
+    byte value;
+    byte mask;
+};
+
+struct compiled_bitmap : compiled_pattern
+{
+    // Every non-wildcard byte, most selective first.
+    std::vector<byte_check> checks;
+
+    compiled_bitmap(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_bitmap(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        for (size_t i = 0; i < size(); ++i)
+        {
+            if (byte_mask[i] != 0)
+                checks.push_back({i, bytes[i], byte_mask[i]});
+        }
+
+        // Fixed bits first, then rarity. Ties keep pattern order.
+        std::stable_sort(checks.begin(), checks.end(), [](const byte_check& lhs, const byte_check& rhs) {
+            return (std::popcount(lhs.mask) * 64 - commonness(lhs.value)) >
+                (std::popcount(rhs.mask) * 64 - commonness(rhs.value));
+        });
+    }
+};
+
+// Calls emit(pos, bits) with the match bits of candidates pos .. pos + 31, for every pos that is a multiple of 32
+// and whose 32 candidates all fit. Returns the first candidate it did not cover, or SIZE_MAX if emit returned false.
+template <typename Emit>
+BENCH_TARGET_AVX2 static size_t scan_blocks(const compiled_bitmap& compiled, const byte* data, size_t last, Emit&& emit)
+{
+    const byte_check* const checks = compiled.checks.data();
+    const size_t count = compiled.checks.size();
+
+    size_t pos = 0;
+    for (; pos + 31 <= last; pos += 32)
+    {
+        __m256i acc = _mm256_set1_epi8(-1);
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            const byte_check& check = checks[k];
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + check.offset));
+            const __m256i masked = _mm256_and_si256(v, _mm256_set1_epi8(static_cast<char>(check.mask)));
+            const __m256i value = _mm256_set1_epi8(static_cast<char>(check.value));
+
+            acc = _mm256_and_si256(acc, _mm256_cmpeq_epi8(masked, value));
+
+            if (_mm256_testz_si256(acc, acc))
+                break;
+        }
+
+        if (!emit(pos, static_cast<uint32_t>(_mm256_movemask_epi8(acc))))
+            return SIZE_MAX;
+    }
+
+    return pos;
+}
+
+static void scan(const compiled_bitmap& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    const size_t last = length - m;
+
+    size_t pos = scan_blocks(compiled, data, last, [&](size_t block, uint32_t bits) {
+        for (; bits; bits &= bits - 1)
+        {
+            if (!results.push(data + block + static_cast<size_t>(std::countr_zero(bits))))
+                return false;
+        }
+        return true;
+    });
+
+    for (; pos <= last; ++pos)
+    {
+        if (compiled.matches(data + pos) && !results.push(data + pos))
+            return;
+    }
+}
+
+static void scan_bitmap(const compiled_bitmap& compiled, const byte* data, size_t length, match_bitmap& results)
+{
+    results.reset(length);
+
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    const size_t last = length - m;
+    uint64_t* const words = results.words();
+
+    // Blocks start on multiples of 32, so each one fills the low or the high half of a word.
+    size_t pos = scan_blocks(compiled, data, last, [&](size_t block, uint32_t bits) {
+        words[block / 64] |= uint64_t(bits) << (block % 64);
+        return true;
+    });
+
+    for (; pos <= last; ++pos)
+    {
+        if (compiled.matches(data + pos))
+            results.set(pos);
+    }
+}
+} // namespace bitmap_impl
+
+struct bitmap_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<bitmap_impl::compiled_bitmap>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<bitmap_impl::compiled_bitmap>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        bitmap_impl::scan(static_cast<const bitmap_impl::compiled_bitmap&>(pattern), data, length, results);
+    }
+
+    virtual void ScanBitmap(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_bitmap& results) const override
+    {
+        bitmap_impl::scan_bitmap(static_cast<const bitmap_impl::compiled_bitmap&>(pattern), data, length, results);
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Bitmap (AVX2)";
+    }
+};
+
+REGISTER_PATTERN(bitmap_pattern_scanner);
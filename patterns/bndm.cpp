@@ -0,0 +1,188 @@
+// BNDM (backward nondeterministic DAWG matching), with wildcards and partial masks.
+//
+// Each window is read backwards. Bit m - 1 - j of the state stays set while the bytes read so far can still be a factor
+// of the pattern that ends at pattern byte j. Whenever the state holds a pattern prefix, the window can at most shift
+// to that prefix, and once the state dies the window skips past everything read. A wildcard sets its bit in every
+// column, so it only ever narrows a skip. It never stops one, wherever in the pattern it sits.
+//
+// Patterns up to 64 bytes keep the state in one word. Longer patterns use a multi-word state of m bits, shifted with a
+// carry between words.
+
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace bndm_impl
+{
+static constexpr size_t word_bits = 64;
+
+struct compiled_bndm : compiled_pattern
+{
+    size_t words {0};
+    std::vector<uint64_t> columns; // columns[c * words + w]: bit m - 1 - j is set when c matches pattern byte j.
+
+    compiled_bndm(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_bndm(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        const size_t m = size();
+        words = (m + word_bits - 1) / word_bits;
+        columns.assign(256 * words, 0);
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            for (size_t j = 0; j < m; ++j)
+            {
+                if ((static_cast<byte>(c) & byte_mask[j]) != (bytes[j] & byte_mask[j]))
+                    continue;
+
+                const size_t bit = m - 1 - j;
+                columns[c * words + bit / word_bits] |= uint64_t(1) << (bit % word_bits);
+            }
+        }
+    }
+};
+
+static void scan_single(const compiled_bndm& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    const uint64_t* const columns = compiled.columns.data();
+    const uint64_t prefix = uint64_t(1) << (m - 1);
+
+    for (size_t pos = 0; pos <= length - m;)
+    {
+        size_t j = m;
+        size_t shift = m;
+        uint64_t state = ~uint64_t(0);
+
+        while (true)
+        {
+            state &= columns[data[pos + j - 1]];
+            if (state == 0)
+                break;
+
+            --j;
+
+            // After all m bytes only the whole-pattern bit can survive, so j == 0 always means a match.
+            if (state & prefix)
+            {
+                if (j == 0)
+                {
+                    if (!results.push(data + pos))
+                        return;
+                    break;
+                }
+
+                shift = j;
+            }
+
+            state <<= 1;
+        }
+
+        pos += shift;
+    }
+}
+
+static void scan_multi(const compiled_bndm& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m > length)
+        return;
+
+    const size_t words = compiled.words;
+    const uint64_t* const columns = compiled.columns.data();
+    const size_t top = (m - 1) / word_bits;
+    const uint64_t prefix = uint64_t(1) << ((m - 1) % word_bits);
+
+    std::vector<uint64_t> state(words);
+
+    for (size_t pos = 0; pos <= length - m;)
+    {
+        size_t j = m;
+        size_t shift = m;
+        std::fill(state.begin(), state.end(), ~uint64_t(0));
+
+        while (true)
+        {
+            const uint64_t* column = columns + data[pos + j - 1] * words;
+
+            uint64_t alive = 0;
+            for (size_t w = 0; w < words; ++w)
+            {
+                state[w] &= column[w];
+                alive |= state[w];
+            }
+
+            if (alive == 0)
+                break;
+
+            --j;
+
+            if (state[top] & prefix)
+            {
+                if (j == 0)
+                {
+                    if (!results.push(data + pos))
+                        return;
+                    break;
+                }
+
+                shift = j;
+            }
+
+            for (size_t w = words - 1; w > 0; --w)
+                state[w] = (state[w] << 1) | (state[w - 1] >> (word_bits - 1));
+            state[0] <<= 1;
+        }
+
+        pos += shift;
+    }
+}
+} // namespace bndm_impl
+
+struct bndm_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<bndm_impl::compiled_bndm>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<bndm_impl::compiled_bndm>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const auto& compiled = static_cast<const bndm_impl::compiled_bndm&>(pattern);
+
+        if (compiled.words <= 1)
+            bndm_impl::scan_single(compiled, data, length, results);
+        else
+            bndm_impl::scan_multi(compiled, data, length, results);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "BNDM";
+    }
+};
+
+REGISTER_PATTERN(bndm_pattern_scanner);
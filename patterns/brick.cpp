@@ -19,27 +19,43 @@
 
 #include "pattern_entry.h"
 
+#include <mem/mem.h>
 #include <mem/pattern.h>
+#include <mem/utils.h>
 
 #include <mem/boyer_moore_scanner.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 struct mem_boyer_moore_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* bytes, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        mem::pattern pattern(bytes, mask);
-        mem::boyer_moore_scanner scanner(pattern);
+        mem::pattern mem_pattern;
+        mem::boyer_moore_scanner scanner;
+
+        compiled(const byte* bytes, const char* mask)
+            : compiled_pattern(bytes, mask)
+            , mem_pattern(bytes, mask)
+            , scanner(mem_pattern)
+        {}
+    };
 
-        std::vector<const byte*> results;
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* bytes, const char* mask) const override
+    {
+        return std::make_unique<compiled>(bytes, mask);
+    }
 
-        scanner({data, length}, [&](mem::pointer result) {
-            results.push_back(result.as<const byte*>());
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const mem::boyer_moore_scanner& scanner = static_cast<const compiled&>(pattern).scanner;
 
-            return false;
+        scanner({data, length}, [&](mem::pointer result) {
+            return !results.push(result.as<const byte*>());
         });
-
-        return results;
     }
 
     virtual const char* GetName() const override
@@ -50,25 +66,59 @@ struct mem_boyer_moore_pattern_scanner : pattern_scanner
 
 REGISTER_PATTERN(mem_boyer_moore_pattern_scanner);
 
+// Only the simd_scanner code is built for AVX2. The mem headers above, which other translation units share, and the
+// registration below stay baseline. mem picks its SIMD path from MEM_SIMD_*, which the target region doesn't imply.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
+#  ifndef MEM_SIMD_AVX2
+#    define MEM_SIMD_AVX2
+#  endif
+#  ifndef MEM_SIMD_AVX
+#    define MEM_SIMD_AVX
+#  endif
+#  ifndef MEM_SIMD_SSSE3
+#    define MEM_SIMD_SSSE3
+#  endif
+#  ifndef MEM_SIMD_SSE3
+#    define MEM_SIMD_SSE3
+#  endif
+#endif
+
+BENCH_PUSH_TARGET_AVX2
 #include <mem/simd_scanner.h>
+BENCH_POP_TARGET
 
 struct mem_simd_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* bytes, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
+    {
+        mem::pattern mem_pattern;
+        mem::simd_scanner scanner;
+
+        compiled(const byte* bytes, const char* mask)
+            : compiled_pattern(bytes, mask)
+            , mem_pattern(bytes, mask)
+            , scanner(mem_pattern)
+        {}
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* bytes, const char* mask) const override
     {
-        mem::pattern pattern(bytes, mask);
-        mem::simd_scanner scanner(pattern);
+        return std::make_unique<compiled>(bytes, mask);
+    }
 
-        std::vector<const byte*> results;
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const mem::simd_scanner& scanner = static_cast<const compiled&>(pattern).scanner;
 
         scanner({data, length}, [&](mem::pointer result) {
-            results.push_back(result.as<const byte*>());
-
-            return false;
+            return !results.push(result.as<const byte*>());
         });
+    }
 
-        return results;
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2 | CPU_BMI1};
     }
 
     virtual const char* GetName() const override
@@ -87,31 +137,53 @@ struct dynamic_freq_scanner : pattern_scanner
         std::uint32_t offset;
     };
 
-    virtual std::vector<const byte*> Scan(
-        const byte* bytes, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        const std::size_t pattern_length = std::strlen(mask);
-
-        if (length < pattern_length)
-            return {};
-
         std::vector<scan_byte> needles;
 
-        for (std::size_t i = pattern_length; i--;)
+        compiled(const byte* bytes, const char* mask)
+            : compiled_pattern(bytes, mask)
         {
-            if (mask[i] == 'x')
-                needles.push_back({bytes[i], static_cast<std::uint32_t>(i)});
+            for (std::size_t i = size(); i--;)
+            {
+                if (mask[i] == 'x')
+                    needles.push_back({bytes[i], static_cast<std::uint32_t>(i)});
+            }
         }
+    };
 
-        if (needles.empty())
-            return {};
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* bytes, const char* mask) const override
+    {
+        return std::make_unique<compiled>(bytes, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const std::size_t pattern_length = pattern.size();
+
+        if (length < pattern_length)
+            return;
+
+        // The needle order adapts to the data, so each scan works on its own copy.
+        std::vector<scan_byte> needles = static_cast<const compiled&>(pattern).needles;
 
         const byte* const end = &data[length - (pattern_length - 1)];
+
+        // All wildcards (e.g. a pattern widened from byte masks): every start matches.
+        if (needles.empty())
+        {
+            for (; data != end; ++data)
+            {
+                if (!results.push(data))
+                    return;
+            }
+            return;
+        }
+
         scan_byte* p_needles = needles.data();
         const std::size_t n_needles = needles.size();
 
-        std::vector<const byte*> results;
-
         while (true)
         {
             scan_byte needle = p_needles[0];
@@ -123,7 +195,8 @@ struct dynamic_freq_scanner : pattern_scanner
             {
                 if (i == n_needles)
                 {
-                    results.push_back(data);
+                    if (!results.push(data))
+                        return;
                     break;
                 }
 
@@ -139,8 +212,6 @@ struct dynamic_freq_scanner : pattern_scanner
 
             ++data;
         }
-
-        return results;
     }
 
     virtual const char* GetName() const override
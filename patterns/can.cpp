@@ -1,5 +1,6 @@
 // Based on Can's cansearch.cpp algorithm (sentinel-first + masked verify).
 
+#include "byte_stats.h"
 #include "pattern_entry.h"
 
 #include <cstdint>
@@ -15,17 +16,6 @@ struct exact_run
     size_t length;
 };
 
-static inline int first_set_bit(uint32_t v)
-{
-#if defined(_MSC_VER)
-    unsigned long idx = 0;
-    _BitScanForward(&idx, v);
-    return static_cast<int>(idx);
-#else
-    return __builtin_ctz(v);
-#endif
-}
-
 static inline bool match_exact_runs(const byte* candidate, const byte* pattern, const std::vector<exact_run>& runs)
 {
     for (size_t i = 0; i < runs.size(); ++i)
@@ -37,13 +27,47 @@ static inline bool match_exact_runs(const byte* candidate, const byte* pattern,
     return true;
 }
 
-static const byte* find_next_anchor_u8(const byte* cursor, const byte* end, byte value)
+// Restricts the anchor search to addresses congruent to phase modulo an alignment of at most 32 bytes.
+// The vector finders mask the movemask with lanes(), so misaligned anchors are never returned or verified.
+struct anchor_align
+{
+    uintptr_t mask {0};
+    uintptr_t phase {0};
+    uint32_t stride {0xFFFFFFFFu}; // One bit every alignment lanes, starting at lane 0.
+
+    anchor_align() = default;
+
+    // Anchors sit first_exact bytes into the candidate, so candidate alignment becomes an anchor phase.
+    anchor_align(size_t alignment, size_t first_exact)
+        : mask(alignment - 1)
+        , phase(first_exact & (alignment - 1))
+        , stride(0)
+    {
+        for (size_t i = 0; i < 32; i += alignment)
+            stride |= 1u << i;
+    }
+
+    // Lanes of the 32-byte block at cursor whose address has the wanted phase. Constant while cursor steps by 32.
+    uint32_t lanes(const byte* cursor) const
+    {
+        return stride << ((phase - reinterpret_cast<uintptr_t>(cursor)) & mask);
+    }
+
+    bool accepts(const byte* anchor) const
+    {
+        return (reinterpret_cast<uintptr_t>(anchor) & mask) == phase;
+    }
+};
+
+BENCH_TARGET_AVX2 static const byte* find_next_anchor_u8(
+    const byte* cursor, const byte* end, byte value, const anchor_align& align)
 {
     const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    const uint32_t lanes = align.lanes(cursor);
     while (cursor + 32 <= end)
     {
         const __m256i hay = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
-        const uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hay, needle)));
+        const uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hay, needle))) & lanes;
         if (bits != 0)
             return cursor + first_set_bit(bits);
         cursor += 32;
@@ -51,7 +75,7 @@ static const byte* find_next_anchor_u8(const byte* cursor, const byte* end, byte
 
     while (cursor < end)
     {
-        if (*cursor == value)
+        if (*cursor == value && align.accepts(cursor))
             return cursor;
         ++cursor;
     }
@@ -59,10 +83,12 @@ static const byte* find_next_anchor_u8(const byte* cursor, const byte* end, byte
     return nullptr;
 }
 
-static const byte* find_next_anchor_u16(const byte* cursor, const byte* end, const byte* value)
+BENCH_TARGET_AVX2 static const byte* find_next_anchor_u16(
+    const byte* cursor, const byte* end, const byte* value, const anchor_align& align)
 {
     const __m256i n0 = _mm256_set1_epi8(static_cast<char>(value[0]));
     const __m256i n1 = _mm256_set1_epi8(static_cast<char>(value[1]));
+    const uint32_t lanes = align.lanes(cursor);
 
     while (cursor + 32 <= end)
     {
@@ -70,7 +96,7 @@ static const byte* find_next_anchor_u16(const byte* cursor, const byte* end, con
         const __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor + 1));
         const uint32_t b0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(d0, n0)));
         const uint32_t b1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(d1, n1)));
-        const uint32_t bits = b0 & b1;
+        const uint32_t bits = b0 & b1 & lanes;
         if (bits != 0)
             return cursor + first_set_bit(bits);
         cursor += 32;
@@ -78,7 +104,7 @@ static const byte* find_next_anchor_u16(const byte* cursor, const byte* end, con
 
     while (cursor < end)
     {
-        if (cursor[0] == value[0] && cursor[1] == value[1])
+        if (cursor[0] == value[0] && cursor[1] == value[1] && align.accepts(cursor))
             return cursor;
         ++cursor;
     }
@@ -86,12 +112,14 @@ static const byte* find_next_anchor_u16(const byte* cursor, const byte* end, con
     return nullptr;
 }
 
-static const byte* find_next_anchor_u32(const byte* cursor, const byte* end, const byte* value)
+BENCH_TARGET_AVX2 static const byte* find_next_anchor_u32(
+    const byte* cursor, const byte* end, const byte* value, const anchor_align& align)
 {
     const __m256i n0 = _mm256_set1_epi8(static_cast<char>(value[0]));
     const __m256i n1 = _mm256_set1_epi8(static_cast<char>(value[1]));
     const __m256i n2 = _mm256_set1_epi8(static_cast<char>(value[2]));
     const __m256i n3 = _mm256_set1_epi8(static_cast<char>(value[3]));
+    const uint32_t lanes = align.lanes(cursor);
 
     while (cursor + 32 <= end)
     {
@@ -104,7 +132,7 @@ static const byte* find_next_anchor_u32(const byte* cursor, const byte* end, con
         const uint32_t b1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(d1, n1)));
         const uint32_t b2 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(d2, n2)));
         const uint32_t b3 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(d3, n3)));
-        const uint32_t bits = b0 & b1 & b2 & b3;
+        const uint32_t bits = b0 & b1 & b2 & b3 & lanes;
         if (bits != 0)
             return cursor + first_set_bit(bits);
 
@@ -113,7 +141,8 @@ static const byte* find_next_anchor_u32(const byte* cursor, const byte* end, con
 
     while (cursor < end)
     {
-        if (cursor[0] == value[0] && cursor[1] == value[1] && cursor[2] == value[2] && cursor[3] == value[3])
+        if (cursor[0] == value[0] && cursor[1] == value[1] && cursor[2] == value[2] && cursor[3] == value[3] &&
+            align.accepts(cursor))
             return cursor;
         ++cursor;
     }
@@ -121,13 +150,14 @@ static const byte* find_next_anchor_u32(const byte* cursor, const byte* end, con
     return nullptr;
 }
 
-static inline const byte* find_next_anchor(const byte* cursor, const byte* end, const byte* value, size_t width)
+BENCH_TARGET_AVX2 static inline const byte* find_next_anchor(
+    const byte* cursor, const byte* end, const byte* value, size_t width, const anchor_align& align)
 {
     if (width == 4)
-        return find_next_anchor_u32(cursor, end, value);
+        return find_next_anchor_u32(cursor, end, value, align);
     if (width == 2)
-        return find_next_anchor_u16(cursor, end, value);
-    return find_next_anchor_u8(cursor, end, value[0]);
+        return find_next_anchor_u16(cursor, end, value, align);
+    return find_next_anchor_u8(cursor, end, value[0], align);
 }
 
 static const byte* find_next_anchor_scalar_u8(const byte* cursor, const byte* end, byte value)
@@ -190,73 +220,164 @@ struct anchor_dispatch;
 template <>
 struct anchor_dispatch<true>
 {
-    static inline const byte* find(const byte* cursor, const byte* end, const byte* value, size_t width)
+    BENCH_TARGET_AVX2 static inline const byte* find(
+        const byte* cursor, const byte* end, const byte* value, size_t width, const anchor_align& align)
     {
-        return find_next_anchor(cursor, end, value, width);
+        return find_next_anchor(cursor, end, value, width, align);
     }
 };
 
 template <>
 struct anchor_dispatch<false>
 {
-    static inline const byte* find(const byte* cursor, const byte* end, const byte* value, size_t width)
+    // memchr cannot skip lanes; FindAllCore drops misaligned anchors before verifying them.
+    static inline const byte* find(
+        const byte* cursor, const byte* end, const byte* value, size_t width, const anchor_align& /*align*/)
     {
         return find_next_anchor_scalar(cursor, end, value, width);
     }
 };
 
-template <bool UseAvx>
-static std::vector<const byte*> FindAllCore(
-    const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled_runs : compiled_pattern
 {
-    std::vector<const byte*> results;
+    std::vector<exact_run> runs;
+    size_t first_exact {0};
+    size_t first_run_length {0};
 
-    const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return results;
+    // Offsets of bytes whose mask is neither 0xFF nor 0x00, checked after the exact runs.
+    std::vector<size_t> partial;
 
-    std::vector<exact_run> runs;
-    runs.reserve(8);
+    // Whole-window and/compare vectors, used for the masked verify when the pattern fits in 32 bytes.
+    alignas(32) byte window_mask[32] {};
+    alignas(32) byte window_value[32] {};
+
+    compiled_runs(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        build_runs();
+    }
 
-    size_t first_exact = pattern_length;
-    for (size_t i = 0; i < pattern_length;)
+    compiled_runs(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
     {
-        if (mask[i] != 'x')
+        build_runs();
+
+        for (size_t i = 0; i < length; ++i)
         {
-            ++i;
-            continue;
+            if (byte_mask[i] != 0x00 && byte_mask[i] != 0xFF)
+                partial.push_back(i);
         }
 
-        if (first_exact == pattern_length)
-            first_exact = i;
+        if (length <= 32)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                window_mask[i] = byte_mask[i];
+                window_value[i] = bytes[i];
+            }
+        }
+    }
 
-        const size_t begin = i;
-        while (i < pattern_length && mask[i] == 'x')
-            ++i;
+    void build_runs()
+    {
+        const size_t pattern_length = size();
+        runs.reserve(8);
 
-        exact_run run {};
-        run.offset = begin;
-        run.length = i - begin;
-        runs.push_back(run);
+        first_exact = pattern_length;
+        for (size_t i = 0; i < pattern_length;)
+        {
+            if (mask[i] != 'x')
+            {
+                ++i;
+                continue;
+            }
+
+            if (first_exact == pattern_length)
+                first_exact = i;
+
+            const size_t begin = i;
+            while (i < pattern_length && mask[i] == 'x')
+                ++i;
+
+            exact_run run {};
+            run.offset = begin;
+            run.length = i - begin;
+            runs.push_back(run);
+        }
+
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            if (runs[i].offset == first_exact)
+            {
+                first_run_length = runs[i].length;
+                break;
+            }
+        }
     }
 
-    if (runs.empty())
+    bool match_partial(const byte* candidate) const
     {
-        const size_t max_start = length - pattern_length;
-        results.reserve(max_start + 1);
-        for (size_t i = 0; i <= max_start; ++i)
-            results.push_back(data + i);
-        return results;
+        for (size_t i = 0; i < partial.size(); ++i)
+        {
+            const size_t j = partial[i];
+            if ((candidate[j] & byte_mask[j]) != bytes[j])
+                return false;
+        }
+        return true;
     }
+};
 
-    size_t first_run_length = 0;
-    for (size_t i = 0; i < runs.size(); ++i)
+// One 32-byte and/compare over the whole candidate. Needs 32 readable bytes at candidate.
+BENCH_TARGET_AVX2 static inline bool match_window_avx(const byte* candidate, const compiled_runs& compiled)
+{
+    const __m256i hay = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidate));
+    const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(compiled.window_mask));
+    const __m256i value = _mm256_load_si256(reinterpret_cast<const __m256i*>(compiled.window_value));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(hay, mask), value)) == -1;
+}
+
+template <bool UseAvx>
+MEM_STRONG_INLINE bool match_candidate(const byte* candidate, const byte* data_end, const compiled_runs& compiled)
+{
+    if (compiled.partial.empty())
+        return match_exact_runs(candidate, compiled.pattern(), compiled.runs);
+
+    if constexpr (UseAvx)
     {
-        if (runs[i].offset == first_exact)
+        if (compiled.size() <= 32 && candidate + 32 <= data_end)
+            return match_window_avx(candidate, compiled);
+    }
+
+    return match_exact_runs(candidate, compiled.pattern(), compiled.runs) && compiled.match_partial(candidate);
+}
+
+// Inlined into FindAllAvx/FindAllNoAvx so the AVX2 instantiation is compiled with their target flags.
+// Only candidates at a multiple of alignment (at most 32) are verified.
+template <bool UseAvx>
+MEM_STRONG_INLINE void FindAllCore(
+    const byte* data, size_t length, const compiled_runs& compiled, size_t alignment, match_sink& results)
+{
+    const size_t pattern_length = compiled.size();
+    if (pattern_length == 0 || pattern_length > length)
+        return;
+
+    const byte* pattern = compiled.pattern();
+    const std::vector<exact_run>& runs = compiled.runs;
+    const size_t first_exact = compiled.first_exact;
+    const size_t first_run_length = compiled.first_run_length;
+
+    if (runs.empty())
+    {
+        const size_t max_start = length - pattern_length;
+        for (size_t i = 0; i <= max_start; ++i)
         {
-            first_run_length = runs[i].length;
-            break;
+            if ((reinterpret_cast<uintptr_t>(data + i) & (alignment - 1)) != 0)
+                continue;
+
+            if (compiled.match_partial(data + i) && !results.push(data + i))
+                return;
         }
+        return;
     }
 
     size_t sentinel_width = 1;
@@ -272,40 +393,72 @@ static std::vector<const byte*> FindAllCore(
     const byte* cursor = data + first_exact;
     const byte* end = data + max_start + first_exact + 1;
     const byte* sentinel = pattern + first_exact;
+    const anchor_align align = (alignment > 1) ? anchor_align(alignment, first_exact) : anchor_align();
 
     while (cursor < end)
     {
-        const byte* hit = anchor_dispatch<UseAvx>::find(cursor, end, sentinel, sentinel_width);
+        const byte* hit = anchor_dispatch<UseAvx>::find(cursor, end, sentinel, sentinel_width, align);
         if (!hit)
             break;
 
+        if (!UseAvx && !align.accepts(hit))
+        {
+            cursor = hit + 1;
+            continue;
+        }
+
         const byte* candidate = hit - first_exact;
-        if (match_exact_runs(candidate, pattern, runs))
-            results.push_back(candidate);
+        if (match_candidate<UseAvx>(candidate, data + length, compiled) && !results.push(candidate))
+            return;
 
         cursor = hit + 1;
     }
-
-    return results;
 }
 
-static std::vector<const byte*> FindAllAvx(const byte* data, size_t length, const byte* pattern, const char* mask)
+BENCH_TARGET_AVX2 static void FindAllAvx(
+    const byte* data, size_t length, const compiled_runs& compiled, size_t alignment, match_sink& results)
 {
-    return FindAllCore<true>(data, length, pattern, mask);
+    FindAllCore<true>(data, length, compiled, alignment, results);
 }
 
-static std::vector<const byte*> FindAllNoAvx(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void FindAllNoAvx(
+    const byte* data, size_t length, const compiled_runs& compiled, size_t alignment, match_sink& results)
 {
-    return FindAllCore<false>(data, length, pattern, mask);
+    FindAllCore<false>(data, length, compiled, alignment, results);
 }
 } // namespace can_impl
 
 struct can_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
     {
-        return can_impl::FindAllAvx(data, length, pattern, mask);
+        return std::make_unique<can_impl::compiled_runs>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<can_impl::compiled_runs>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        can_impl::FindAllAvx(data, length, static_cast<const can_impl::compiled_runs&>(pattern), 1, results);
+    }
+
+    virtual void ScanAlignedInto(const compiled_pattern& pattern, const byte* data, size_t length, size_t alignment,
+        match_sink& results) const override
+    {
+        if (alignment > 32)
+            return pattern_scanner::ScanAlignedInto(pattern, data, length, alignment, results);
+
+        can_impl::FindAllAvx(data, length, static_cast<const can_impl::compiled_runs&>(pattern), alignment, results);
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2 | CPU_BMI1, .fallback = "Can (Scalar)"};
     }
 
     virtual const char* GetName() const override
@@ -318,10 +471,30 @@ REGISTER_PATTERN(can_pattern_scanner);
 
 struct can_no_avx_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<can_impl::compiled_runs>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
     {
-        return can_impl::FindAllNoAvx(data, length, pattern, mask);
+        return std::make_unique<can_impl::compiled_runs>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        can_impl::FindAllNoAvx(data, length, static_cast<const can_impl::compiled_runs&>(pattern), 1, results);
+    }
+
+    virtual void ScanAlignedInto(const compiled_pattern& pattern, const byte* data, size_t length, size_t alignment,
+        match_sink& results) const override
+    {
+        if (alignment > 32)
+            return pattern_scanner::ScanAlignedInto(pattern, data, length, alignment, results);
+
+        can_impl::FindAllNoAvx(data, length, static_cast<const can_impl::compiled_runs&>(pattern), alignment, results);
     }
 
     virtual const char* GetName() const override
@@ -9,25 +9,41 @@
 
 struct cfx_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        size_t mask_size = strlen(mask);
         ptrdiff_t last[256];
 
-        const char* findWild = strrchr(mask, '?');
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            size_t mask_size = size();
 
-        std::fill(std::begin(last), std::end(last), findWild ? (findWild - mask) : -1);
+            const char* findWild = strrchr(mask, '?');
 
-        for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(mask_size); ++i)
-        {
-            if (last[pattern[i]] < i)
+            std::fill(std::begin(last), std::end(last), findWild ? (findWild - mask) : -1);
+
+            for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(mask_size); ++i)
             {
-                last[pattern[i]] = i;
+                if (last[pattern[i]] < i)
+                {
+                    last[pattern[i]] = i;
+                }
             }
         }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
 
-        std::vector<const byte*> results;
+    virtual void ScanInto(
+        const compiled_pattern& compiled_data, const byte* data, size_t length, match_sink& results) const override
+    {
+        const byte* pattern = compiled_data.pattern();
+        const char* mask = compiled_data.masks();
+        const ptrdiff_t* last = static_cast<const compiled&>(compiled_data).last;
+        size_t mask_size = compiled_data.size();
 
         for (const byte *i = data, *end = data + length - mask_size; i <= end;)
         {
@@ -38,7 +54,8 @@ struct cfx_pattern_scanner : pattern_scanner
 
             if (j < 0)
             {
-                results.emplace_back(i);
+                if (!results.push(i))
+                    return;
 
                 i++;
             }
@@ -47,8 +64,6 @@ struct cfx_pattern_scanner : pattern_scanner
                 i += std::max((ptrdiff_t) 1, j - last[i[j]]);
             }
         }
-
-        return results;
     }
 
     virtual const char* GetName() const override
@@ -8,23 +8,26 @@
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 
-static std::vector<const byte*> find_masked(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void fill_last_table(const byte* pattern, const char* mask, ptrdiff_t* last)
 {
     const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return {};
-
-    ptrdiff_t last[UCHAR_MAX + 1];
     const char* wild = std::strrchr(mask, '?');
-    std::fill(std::begin(last), std::end(last), wild ? (wild - mask) : -1);
+    std::fill(last, last + UCHAR_MAX + 1, wild ? (wild - mask) : -1);
 
     for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(pattern_length); ++i)
     {
         if (mask[i] == 'x' && last[pattern[i]] < i)
             last[pattern[i]] = i;
     }
+}
+
+static void find_masked(const byte* data, size_t length, const byte* pattern, const char* mask, const ptrdiff_t* last,
+    match_sink& results)
+{
+    const size_t pattern_length = std::strlen(mask);
+    if (pattern_length == 0 || pattern_length > length)
+        return;
 
-    std::vector<const byte*> results;
     for (const byte *cursor = data, *end = data + (length - pattern_length); cursor <= end;)
     {
         ptrdiff_t i = static_cast<ptrdiff_t>(pattern_length) - 1;
@@ -33,7 +36,8 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
 
         if (i < 0)
         {
-            results.push_back(cursor);
+            if (!results.push(cursor))
+                return;
             ++cursor;
         }
         else
@@ -41,8 +45,6 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
             cursor += std::max<ptrdiff_t>(1, i - last[cursor[i]]);
         }
     }
-
-    return results;
 }
 
 // Boyer-Moore-Horspool with wildcards implementation
@@ -65,30 +67,24 @@ void FillShiftTable(const uint8_t* pPattern, size_t patternSize, const char* pMa
         bad_char_skip[pPattern[idx]] = last - idx;
 }
 
-std::vector<const byte*> Search(const uint8_t* pScanPos, size_t scanSize, const uint8_t* pPattern, const char* pMask)
+void Search(const uint8_t* pScanPos, size_t scanSize, const uint8_t* pPattern, const char* pMask,
+    const size_t* bad_char_skip, match_sink& results)
 {
     size_t patternSize = strlen(pMask);
 
-    size_t bad_char_skip[UCHAR_MAX + 1];
     const uint8_t* scanEnd = pScanPos + scanSize - patternSize;
     intptr_t last = static_cast<intptr_t>(patternSize) - 1;
 
-    FillShiftTable(pPattern, patternSize, pMask, bad_char_skip);
-
-    std::vector<const byte*> results;
-
     // Search
     for (; pScanPos <= scanEnd; pScanPos += bad_char_skip[pScanPos[last]])
     {
         for (intptr_t idx = last; idx >= 0; --idx)
             if (pMask[idx] != '?' && pScanPos[idx] != pPattern[idx])
                 goto skip;
-            else if (idx == 0)
-                results.push_back(pScanPos);
+            else if (idx == 0 && !results.push(pScanPos))
+                return;
     skip:;
     }
-
-    return results;
 }
 
 struct PartData
@@ -103,17 +99,35 @@ struct PartData
     }
 };
 
-std::vector<const byte*> Search2(const uint8_t* data, const uint32_t size, const uint8_t* pattern, const char* mask)
+void Search2(const uint8_t* data, const uint32_t size, const uint8_t* pattern, const char* mask, const ptrdiff_t* last,
+    match_sink& results)
 {
-    return find_masked(data, size, pattern, mask);
+    find_masked(data, size, pattern, mask, last, results);
 }
 
 struct darth_ton_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        return Search(data, length, pattern, mask);
+        size_t bad_char_skip[UCHAR_MAX + 1];
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            FillShiftTable(pattern, size(), mask, bad_char_skip);
+        }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        Search(data, length, pattern.pattern(), pattern.masks(), static_cast<const compiled&>(pattern).bad_char_skip,
+            results);
     }
 
     virtual const char* GetName() const override
@@ -126,10 +140,26 @@ REGISTER_PATTERN(darth_ton_pattern_scanner);
 
 struct darth_ton2_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
+    {
+        ptrdiff_t last[UCHAR_MAX + 1];
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            fill_last_table(pattern, mask, last);
+        }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return Search2(data, length, pattern, mask);
+        Search2(data, length, pattern.pattern(), pattern.masks(), static_cast<const compiled&>(pattern).last, results);
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,435 @@
+// Hashed q-gram filter for large signature sets, in the spirit of Wu-Manber and Hyperscan's FDR.
+//
+// Every pattern contributes one wildcard-free q-gram: four exact bytes, or its longest exact run when that is shorter.
+// The gram goes where it is rarest in a sample of the data, counted as a whole gram since code repeats whole
+// instructions far more often than byte frequencies predict. Grams are hashed into a sparse bit filter, and a
+// single sweep hashes the gram at every position. Only positions whose filter bit is set look up the hash bucket,
+// compare the whole gram and verify the patterns that own it, by id.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace fdr_impl
+{
+static constexpr size_t max_gram = 4;
+
+static inline uint32_t hash_gram(uint32_t gram, unsigned bits)
+{
+    return (gram * 0x9E3779B1u) >> (32 - bits);
+}
+
+static inline uint32_t gram_mask(size_t q)
+{
+    return (q == 4) ? 0xFFFFFFFFu : ((1u << (8 * q)) - 1);
+}
+
+// Sampled gram and byte frequencies of the data being scanned, or a flat prior when there is no data yet.
+struct data_sample
+{
+    static constexpr unsigned count_bits = 16;
+
+    std::vector<uint16_t> gram_counts[max_gram]; // Hashed, so collisions only ever overestimate.
+    byte_sample bytes;
+
+    data_sample() = default;
+
+    data_sample(const byte* data, size_t length)
+        : bytes(data, length)
+    {
+        for (std::vector<uint16_t>& table : gram_counts)
+            table.assign(size_t(1) << count_bits, 0);
+
+        byte_sample::for_each_block(data, length, [this](const byte* start) {
+            for (size_t j = 0; j < byte_sample::block; ++j)
+            {
+                uint32_t gram = 0;
+                for (size_t q = 1; q <= max_gram && j + q <= byte_sample::block; ++q)
+                {
+                    gram |= uint32_t(start[j + q - 1]) << (8 * (q - 1));
+                    uint16_t& count = gram_counts[q - 1][hash_gram(gram, count_bits)];
+                    count += (count != UINT16_MAX);
+                }
+            }
+        });
+    }
+
+    // Lower is rarer. Sampled gram counts decide, and byte shares break ties between grams the sample never saw.
+    double score(const byte* gram_bytes, size_t q) const
+    {
+        double shares = 0.0;
+        uint32_t gram = 0;
+        for (size_t j = 0; j < q; ++j)
+        {
+            shares += bytes.log_share[gram_bytes[j]];
+            gram |= uint32_t(gram_bytes[j]) << (8 * j);
+        }
+
+        const double seen = gram_counts[q - 1].empty() ? 0.0 : gram_counts[q - 1][hash_gram(gram, count_bits)];
+        return seen * 64.0 + shares;
+    }
+};
+
+struct entry
+{
+    uint32_t gram;
+    uint32_t id;          // Index into set::patterns.
+    uint32_t offset;      // Where the gram starts in the pattern.
+    uint64_t head_value;  // The first 8 pattern bytes, masked, so most misses never touch the pattern arenas.
+    uint64_t head_mask;
+};
+
+struct stored_pattern
+{
+    uint32_t id;
+    uint32_t begin; // Into set::values and set::masks.
+    uint32_t length;
+};
+
+// All grams of one length.
+struct gram_table
+{
+    size_t q {0};
+    uint32_t gram_mask {0};
+    unsigned filter_bits {0};
+    unsigned bucket_shift {0};
+
+    std::vector<uint64_t> filter;
+    std::vector<uint32_t> starts; // Bucket b holds entries [starts[b], starts[b + 1]).
+    std::vector<entry> entries;
+
+    uint32_t hash(uint32_t gram) const
+    {
+        return hash_gram(gram, filter_bits);
+    }
+
+    bool test(uint32_t h) const
+    {
+        return (filter[h >> 6] >> (h & 63)) & 1;
+    }
+
+    void build(std::vector<entry> grams)
+    {
+        unsigned bucket_bits = 0;
+        while ((size_t(1) << bucket_bits) < grams.size())
+            ++bucket_bits;
+
+        // About 16 filter bits per gram keeps most misses to one load and one bit test. Small sets still get a 4 KiB
+        // filter, since a handful of bits would pass most positions.
+        filter_bits = (std::clamp)(bucket_bits + 4, 15u, 24u);
+        bucket_shift = filter_bits - (std::min)(bucket_bits, filter_bits);
+
+        filter.assign(((size_t(1) << filter_bits) + 63) / 64, 0);
+        starts.assign((size_t(1) << (filter_bits - bucket_shift)) + 1, 0);
+
+        for (const entry& e : grams)
+        {
+            const uint32_t h = hash(e.gram);
+            filter[h >> 6] |= uint64_t(1) << (h & 63);
+            ++starts[(h >> bucket_shift) + 1];
+        }
+
+        for (size_t b = 1; b < starts.size(); ++b)
+            starts[b] += starts[b - 1];
+
+        entries.resize(grams.size());
+        std::vector<uint32_t> fill(starts.begin(), starts.end() - 1);
+        for (const entry& e : grams)
+            entries[fill[hash(e.gram) >> bucket_shift]++] = e;
+    }
+};
+
+struct set
+{
+    gram_table tables[max_gram]; // tables[q - 1]
+    std::vector<stored_pattern> patterns;
+    std::vector<stored_pattern> unfiltered; // No exact byte to hash, verified everywhere.
+    std::vector<byte> values;
+    std::vector<byte> masks;
+
+    // Adds a pattern with per-byte masks. Only 0xFF bytes can be part of a gram.
+    void add(uint32_t id, const byte* pattern, const byte* byte_masks, size_t length, const data_sample& sample)
+    {
+        const stored_pattern stored {id, static_cast<uint32_t>(values.size()), static_cast<uint32_t>(length)};
+        for (size_t i = 0; i < length; ++i)
+        {
+            values.push_back(pattern[i] & byte_masks[i]);
+            masks.push_back(byte_masks[i]);
+        }
+
+        size_t longest = 0;
+        for (size_t i = 0, run = 0; i < length; ++i)
+        {
+            run = (byte_masks[i] == 0xFF) ? (run + 1) : 0;
+            longest = (std::max)(longest, run);
+        }
+
+        if (longest == 0)
+        {
+            unfiltered.push_back(stored);
+            return;
+        }
+
+        const size_t q = (std::min)(longest, max_gram);
+        size_t best_offset = SIZE_MAX;
+        double best = 0.0;
+
+        for (size_t offset = 0; offset + q <= length; ++offset)
+        {
+            size_t j = 0;
+            while (j < q && byte_masks[offset + j] == 0xFF)
+                ++j;
+
+            if (j != q)
+                continue;
+
+            const double score = sample.score(pattern + offset, q);
+            if (best_offset == SIZE_MAX || score < best)
+            {
+                best = score;
+                best_offset = offset;
+            }
+        }
+
+        uint32_t gram = 0;
+        for (size_t j = 0; j < q; ++j)
+            gram |= uint32_t(pattern[best_offset + j]) << (8 * j);
+
+        entry e {gram, static_cast<uint32_t>(patterns.size()), static_cast<uint32_t>(best_offset), 0, 0};
+        for (size_t j = 0; j < (std::min)(length, size_t(8)); ++j)
+        {
+            e.head_value |= uint64_t(pattern[j] & byte_masks[j]) << (8 * j);
+            e.head_mask |= uint64_t(byte_masks[j]) << (8 * j);
+        }
+
+        pending_[q - 1].push_back(e);
+        patterns.push_back(stored);
+    }
+
+    void build()
+    {
+        for (size_t q = 1; q <= max_gram; ++q)
+        {
+            tables[q - 1].q = q;
+            tables[q - 1].gram_mask = gram_mask(q);
+
+            if (!pending_[q - 1].empty())
+                tables[q - 1].build(std::move(pending_[q - 1]));
+        }
+    }
+
+    bool verify(const stored_pattern& p, const byte* candidate) const
+    {
+        const byte* v = values.data() + p.begin;
+        const byte* m = masks.data() + p.begin;
+
+        for (size_t i = 0; i < p.length; ++i)
+        {
+            if (((candidate[i] ^ v[i]) & m[i]) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<entry> pending_[max_gram];
+};
+
+// Checks the gram of every table at pos. Report(id, match) returns false to stop the scan.
+template <typename Report>
+static inline bool check_position(
+    const set& s, const gram_table* const* active, size_t active_count, const byte* data, const byte* end,
+    const byte* pos, uint32_t window, Report& report)
+{
+    for (size_t t = 0; t < active_count; ++t)
+    {
+        const gram_table& table = *active[t];
+        if (table.q > static_cast<size_t>(end - pos))
+            continue;
+
+        const uint32_t gram = window & table.gram_mask;
+        const uint32_t h = table.hash(gram);
+        if (!table.test(h))
+            continue;
+
+        const uint32_t bucket = h >> table.bucket_shift;
+        for (uint32_t i = table.starts[bucket]; i < table.starts[bucket + 1]; ++i)
+        {
+            const entry& e = table.entries[i];
+            if (e.gram != gram || static_cast<size_t>(pos - data) < e.offset)
+                continue;
+
+            const byte* candidate = pos - e.offset;
+            if (static_cast<size_t>(end - candidate) >= 8)
+            {
+                uint64_t head;
+                std::memcpy(&head, candidate, sizeof(head));
+
+                if (((head ^ e.head_value) & e.head_mask) != 0)
+                    continue;
+            }
+
+            const stored_pattern& p = s.patterns[e.id];
+            if (p.length > static_cast<size_t>(end - candidate) || !s.verify(p, candidate))
+                continue;
+
+            if (!report(p.id, candidate))
+                return false;
+        }
+    }
+
+    for (const stored_pattern& p : s.unfiltered)
+    {
+        if (p.length <= static_cast<size_t>(end - pos) && s.verify(p, pos) && !report(p.id, pos))
+            return false;
+    }
+
+    return true;
+}
+
+template <typename Report>
+static void scan(const set& s, const byte* data, size_t length, Report& report)
+{
+    const gram_table* active[max_gram];
+    size_t active_count = 0;
+    for (const gram_table& table : s.tables)
+    {
+        if (!table.entries.empty())
+            active[active_count++] = &table;
+    }
+
+    const byte* const end = data + length;
+    const byte* pos = data;
+
+    // Four windows per 8-byte load. Only positions that pass a filter leave the loop.
+    if (s.unfiltered.empty())
+    {
+        for (; pos + 8 <= end; pos += 4)
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, pos, sizeof(chunk));
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                const uint32_t window = static_cast<uint32_t>(chunk >> (8 * k));
+
+                bool hit = false;
+                for (size_t t = 0; t < active_count; ++t)
+                    hit |= active[t]->test(active[t]->hash(window & active[t]->gram_mask));
+
+                if (hit && !check_position(s, active, active_count, data, end, pos + k, window, report))
+                    return;
+            }
+        }
+    }
+
+    for (; pos + 4 <= end; ++pos)
+    {
+        uint32_t window;
+        std::memcpy(&window, pos, sizeof(window));
+
+        if (!check_position(s, active, active_count, data, end, pos, window, report))
+            return;
+    }
+
+    // The last few positions only have room for shorter grams.
+    for (; pos < end; ++pos)
+    {
+        uint32_t window = 0;
+        for (size_t j = 0; pos + j < end; ++j)
+            window |= uint32_t(pos[j]) << (8 * j);
+
+        if (!check_position(s, active, active_count, data, end, pos, window, report))
+            return;
+    }
+}
+
+struct compiled_fdr : compiled_pattern
+{
+    set filter;
+
+    compiled_fdr(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        filter.add(0, bytes.data(), byte_mask.data(), size(), data_sample());
+        filter.build();
+    }
+
+    compiled_fdr(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        filter.add(0, bytes.data(), byte_mask.data(), size(), data_sample());
+        filter.build();
+    }
+};
+} // namespace fdr_impl
+
+struct fdr_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<fdr_impl::compiled_fdr>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<fdr_impl::compiled_fdr>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        auto report = [&results](uint32_t, const byte* match) { return results.push(match); };
+
+        fdr_impl::scan(static_cast<const fdr_impl::compiled_fdr&>(pattern).filter, data, length, report);
+    }
+
+    // Builds one filter for the whole set and sweeps the data once.
+    virtual std::vector<std::vector<const byte*>> ScanMany(const byte* const* patterns, const char* const* masks,
+        size_t count, const byte* data, size_t length) const override
+    {
+        std::vector<std::vector<const byte*>> results(count);
+        auto report = [&results](uint32_t id, const byte* match) {
+            results[id].push_back(match);
+            return true;
+        };
+
+        const fdr_impl::data_sample sample(data, length);
+        fdr_impl::set filter;
+        std::vector<byte> byte_masks;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t pattern_length = std::strlen(masks[i]);
+            byte_masks.resize(pattern_length);
+            for (size_t j = 0; j < pattern_length; ++j)
+                byte_masks[j] = (masks[i][j] == 'x') ? 0xFF : 0x00;
+
+            filter.add(static_cast<uint32_t>(i), patterns[i], byte_masks.data(), pattern_length, sample);
+        }
+
+        filter.build();
+        fdr_impl::scan(filter, data, length, report);
+
+        return results;
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.multi_pattern = true};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "FDR (q-gram hash)";
+    }
+};
+
+REGISTER_PATTERN(fdr_pattern_scanner);
@@ -11,23 +11,26 @@
 #define FORZA_HAS_X86_SIMD
 #endif
 
-static std::vector<const byte*> find_masked(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void fill_last_table(const byte* pattern, const char* mask, ptrdiff_t* last)
 {
     const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return {};
-
-    ptrdiff_t last[UCHAR_MAX + 1];
     const char* wild = std::strrchr(mask, '?');
-    std::fill(std::begin(last), std::end(last), wild ? (wild - mask) : -1);
+    std::fill(last, last + UCHAR_MAX + 1, wild ? (wild - mask) : -1);
 
     for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(pattern_length); ++i)
     {
         if (mask[i] == 'x' && last[pattern[i]] < i)
             last[pattern[i]] = i;
     }
+}
+
+static void find_masked(const byte* data, size_t length, const byte* pattern, const char* mask, const ptrdiff_t* last,
+    match_sink& results)
+{
+    const size_t pattern_length = std::strlen(mask);
+    if (pattern_length == 0 || pattern_length > length)
+        return;
 
-    std::vector<const byte*> results;
     for (const byte *cursor = data, *end = data + (length - pattern_length); cursor <= end;)
     {
         ptrdiff_t i = static_cast<ptrdiff_t>(pattern_length) - 1;
@@ -36,7 +39,8 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
 
         if (i < 0)
         {
-            results.push_back(cursor);
+            if (!results.push(cursor))
+                return;
             ++cursor;
         }
         else
@@ -44,8 +48,6 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
             cursor += std::max<ptrdiff_t>(1, i - last[cursor[i]]);
         }
     }
-
-    return results;
 }
 
 #ifdef FORZA_HAS_X86_SIMD
@@ -116,7 +118,7 @@ void GeneratePattern(const char* Signature, const char* Mask, PatternData* Out)
     Out->Size = l;
 }
 
-MEM_STRONG_INLINE bool Matches(const uint8_t* Data, PatternData* Patterns)
+MEM_STRONG_INLINE BENCH_TARGET_SSE42 bool Matches(const uint8_t* Data, const PatternData* Patterns)
 {
     for (auto i = 0u; i < Patterns->Count; i++)
     {
@@ -131,7 +133,7 @@ MEM_STRONG_INLINE bool Matches(const uint8_t* Data, PatternData* Patterns)
     return true;
 }
 
-MEM_STRONG_INLINE bool MatchesFast(const uint8_t* Data, PatternData* Patterns)
+MEM_STRONG_INLINE BENCH_TARGET_SSE42 bool MatchesFast(const uint8_t* Data, const PatternData* Patterns)
 {
     for (auto i = 0u; i < Patterns->Count; i++)
     {
@@ -146,7 +148,7 @@ MEM_STRONG_INLINE bool MatchesFast(const uint8_t* Data, PatternData* Patterns)
     return true;
 }
 
-MEM_STRONG_INLINE bool MatchesTail(const uint8_t* Data, const uint8_t* DataEnd, PatternData* Patterns)
+MEM_STRONG_INLINE BENCH_TARGET_SSE42 bool MatchesTail(const uint8_t* Data, const uint8_t* DataEnd, const PatternData* Patterns)
 {
     for (auto i = 0u; i < Patterns->Count; i++)
     {
@@ -164,21 +166,21 @@ MEM_STRONG_INLINE bool MatchesTail(const uint8_t* Data, const uint8_t* DataEnd,
     return true;
 }
 
-std::vector<const byte*> FindEx(const uint8_t* Data, const uint32_t Length, const char* Signature, const char* Mask)
+BENCH_TARGET_SSE42 void FindEx(const uint8_t* Data, const uint32_t Length, const PatternData& Pattern, match_sink& results)
 {
-    PatternData d;
-    GeneratePattern(Signature, Mask, &d);
+    const PatternData& d = Pattern;
 
     if (d.Size == 0 || d.Size > Length)
-        return {};
-
-    std::vector<const byte*> results;
+        return;
 
     if (d.Count == 0)
     {
         for (uint32_t i = 0; i <= Length - d.Size; ++i)
-            results.push_back(Data + i);
-        return results;
+        {
+            if (!results.push(Data + i))
+                return;
+        }
+        return;
     }
 
     const int anchor_length = static_cast<int>(d.Length[0]);
@@ -213,8 +215,8 @@ std::vector<const byte*> FindEx(const uint8_t* Data, const uint32_t Length, cons
                     (has_fast_match_path && candidate <= fast_match_end)
                     ? MatchesFast(candidate, &d)
                     : MatchesTail(candidate, data_end, &d);
-                if (matched)
-                    results.push_back(candidate);
+                if (matched && !results.push(candidate))
+                    return;
             }
 
             search = anchor_hit + 1;
@@ -226,8 +228,6 @@ std::vector<const byte*> FindEx(const uint8_t* Data, const uint32_t Length, cons
             search += no_match_advance;
         }
     }
-
-    return results;
 }
 #endif // FORZA_HAS_X86_SIMD
 
@@ -259,17 +259,35 @@ void FindLargestArray(const char* Signature, const char* Mask, int Out[2])
     Out[1] = t2;
 }
 
-std::vector<const byte*> Find(const byte* Data, const uint32_t Length, const char* Signature, const char* Mask)
+void Find(const byte* Data, const uint32_t Length, const char* Signature, const char* Mask, const ptrdiff_t* Last,
+    match_sink& results)
 {
-    return find_masked(Data, Length, reinterpret_cast<const byte*>(Signature), Mask);
+    find_masked(Data, Length, reinterpret_cast<const byte*>(Signature), Mask, Last, results);
 }
 
 struct forza_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        return Find(data, length, (const char*) pattern, mask);
+        ptrdiff_t last[UCHAR_MAX + 1];
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            fill_last_table(pattern, mask, last);
+        }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        Find(data, length, (const char*) pattern.pattern(), pattern.masks(), static_cast<const compiled&>(pattern).last,
+            results);
     }
 
     virtual const char* GetName() const override
@@ -283,10 +301,31 @@ REGISTER_PATTERN(forza_pattern_scanner);
 #ifdef FORZA_HAS_X86_SIMD
 struct forza_simd_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
+    {
+        PatternData data;
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            GeneratePattern((const char*) pattern, mask, &data);
+        }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        FindEx(data, length, static_cast<const compiled&>(pattern).data, results);
+    }
+
+    virtual scanner_traits GetTraits() const override
     {
-        return FindEx(data, length, (const char*) pattern, mask);
+        return {.isa = CPU_SSE41 | CPU_SSE42};
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,260 @@
+// Horspool on the longest wildcard-free window of the signature, wherever it sits.
+//
+// Tail-based Horspool tables lose their shift once a wildcard sits near the end of the pattern, since a wildcard
+// matches every byte. Here the bad-character table covers only the window, so a trailing '?' costs nothing. Window
+// alignments are tracked by the position of the window's last byte. The rest of the pattern, partial bytes included,
+// is verified at each window hit.
+//
+// The AVX2 kernel tests 32 consecutive alignments per step against the two rarest window bytes. It then shifts on the
+// last byte of the 32nd alignment, so every step moves at least 32 bytes.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace horspool_window_impl
+{
+struct compiled_horspool_window : compiled_pattern
+{
+    size_t window_offset {0};
+    size_t window_length {0}; // 0 when the pattern has no exact byte.
+    size_t shifts[256] {};
+
+    // Window offsets of the two bytes the AVX2 kernel filters on. They are equal for a one-byte window.
+    size_t probe_a {0};
+    size_t probe_b {0};
+
+    compiled_horspool_window(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_horspool_window(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        // The longest run of exact bytes. On a tie the later run wins, since its window end sits further right and
+        // rejects a misaligned window sooner.
+        for (size_t i = 0; i < size();)
+        {
+            if (byte_mask[i] != 0xFF)
+            {
+                ++i;
+                continue;
+            }
+
+            size_t run = 1;
+            while (i + run < size() && byte_mask[i + run] == 0xFF)
+                ++run;
+
+            if (run >= window_length)
+            {
+                window_offset = i;
+                window_length = run;
+            }
+
+            i += run;
+        }
+
+        for (size_t& shift : shifts)
+            shift = window_length;
+
+        for (size_t j = 0; j + 1 < window_length; ++j)
+            shifts[bytes[window_offset + j]] = window_length - 1 - j;
+
+        if (window_length == 0)
+            return;
+
+        // The two rarest window bytes. On a tie the last byte is kept, since it is read anyway for the shift.
+        const byte* const w = window();
+        probe_a = window_length - 1;
+        for (size_t j = window_length - 1; j-- != 0;)
+        {
+            if (commonness(w[j]) < commonness(w[probe_a]))
+                probe_a = j;
+        }
+
+        probe_b = probe_a;
+        for (size_t j = window_length; j-- != 0;)
+        {
+            if (j != probe_a && (probe_b == probe_a || commonness(w[j]) < commonness(w[probe_b])))
+                probe_b = j;
+        }
+    }
+
+    // Offset of the window's last byte from the pattern start.
+    size_t window_end() const
+    {
+        return window_offset + window_length - 1;
+    }
+
+    const byte* window() const
+    {
+        return bytes.data() + window_offset;
+    }
+};
+
+// Pattern starts in [first, last], checked without a window.
+static void scan_unanchored(
+    const compiled_horspool_window& compiled, const byte* first, const byte* last, match_sink& results)
+{
+    for (const byte* candidate = first; candidate <= last; ++candidate)
+    {
+        if (compiled.matches(candidate) && !results.push(candidate))
+            return;
+    }
+}
+
+// Window ends in [begin, end], where end is the window end of the last pattern start that fits.
+static void scan_scalar(
+    const compiled_horspool_window& compiled, const byte* data, size_t begin, size_t end, match_sink& results)
+{
+    const size_t last = compiled.window_length - 1;
+    const byte* const window = compiled.window();
+
+    for (size_t pos = begin; pos <= end;)
+    {
+        const byte c = data[pos];
+
+        if (c == window[last])
+        {
+            size_t j = last;
+            while (j != 0 && data[pos - last + j - 1] == window[j - 1])
+                --j;
+
+            const byte* candidate = data + pos - compiled.window_end();
+            if (j == 0 && compiled.matches(candidate) && !results.push(candidate))
+                return;
+        }
+
+        pos += compiled.shifts[c];
+    }
+}
+
+BENCH_TARGET_AVX2 static void scan_avx2(
+    const compiled_horspool_window& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    const size_t last = compiled.window_length - 1;
+    const byte* const window = compiled.window();
+
+    // Window ends of the first and the last pattern start that fit.
+    const size_t begin = compiled.window_end();
+    const size_t end = length - m + compiled.window_end();
+
+    const __m256i byte_a = _mm256_set1_epi8(static_cast<char>(window[compiled.probe_a]));
+    const __m256i byte_b = _mm256_set1_epi8(static_cast<char>(window[compiled.probe_b]));
+    const size_t back_a = last - compiled.probe_a;
+    const size_t back_b = last - compiled.probe_b;
+
+    size_t pos = begin;
+    while (pos + 31 <= end)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos - back_a));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos - back_b));
+
+        uint32_t hits = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, byte_a), _mm256_cmpeq_epi8(b, byte_b))));
+
+        for (; hits; hits &= hits - 1)
+        {
+            const byte* candidate = data + pos + first_set_bit(hits) - compiled.window_end();
+            if (compiled.matches(candidate) && !results.push(candidate))
+                return;
+        }
+
+        // Alignments pos .. pos + 31 are done. The 32nd one's last byte rules out the next shift - 1 alignments.
+        pos += 31 + compiled.shifts[data[pos + 31]];
+    }
+
+    if (pos <= end)
+        scan_scalar(compiled, data, pos, end, results);
+}
+
+static void scan(const compiled_horspool_window& compiled, const byte* data, size_t length, match_sink& results,
+    bool use_avx2)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    if (compiled.window_length == 0)
+    {
+        scan_unanchored(compiled, data, data + (length - m), results);
+        return;
+    }
+
+    if (use_avx2)
+        scan_avx2(compiled, data, length, results);
+    else
+        scan_scalar(compiled, data, compiled.window_end(), length - m + compiled.window_end(), results);
+}
+} // namespace horspool_window_impl
+
+struct horspool_window_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<horspool_window_impl::compiled_horspool_window>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<horspool_window_impl::compiled_horspool_window>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        horspool_window_impl::scan(
+            static_cast<const horspool_window_impl::compiled_horspool_window&>(pattern), data, length, results, true);
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2, .fallback = "Window Horspool (Scalar)"};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Window Horspool (AVX2)";
+    }
+};
+
+REGISTER_PATTERN(horspool_window_pattern_scanner);
+
+struct horspool_window_scalar_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<horspool_window_impl::compiled_horspool_window>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<horspool_window_impl::compiled_horspool_window>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        horspool_window_impl::scan(
+            static_cast<const horspool_window_impl::compiled_horspool_window&>(pattern), data, length, results, false);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Window Horspool (Scalar)";
+    }
+};
+
+REGISTER_PATTERN(horspool_window_scalar_pattern_scanner);
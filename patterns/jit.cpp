@@ -0,0 +1,411 @@
+// Per-pattern x86-64 machine code.
+//
+// Compile emits a find-next function for the signature. An SSE2 loop tests 16 candidates at a time against its first
+// and last exact bytes. Each candidate is then verified with compare immediates over its exact runs, 8/4/2/1 bytes at
+// a time, and an and/compare per partial byte. Wildcards emit no code at all. The function is written into RW pages,
+// which are then flipped to RX, and on Linux it gets a /tmp/perf-<pid>.map entry so profilers can name it.
+//
+// JIT time is the compile time the harness already reports per pattern. The scan loop only calls the generated
+// function and pushes its results.
+
+#include "pattern_entry.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#  include <cstdint>
+#  include <cstdio>
+#  include <cstring>
+#  include <new>
+#  include <stdexcept>
+#  include <vector>
+
+#  include <mem/protect.h>
+
+#  if defined(__linux__)
+#    include <unistd.h>
+#  endif
+
+namespace jit_impl
+{
+// Returns the first match starting in [cursor, last], or nullptr.
+using find_next_fn = const byte* (*) (const byte* cursor, const byte* last);
+
+enum condition : byte
+{
+    cc_equal = 0x4,
+    cc_not_equal = 0x5,
+    cc_above = 0x7,
+};
+
+// Just enough of an x86-64 encoder for the code below. Jumps are always rel32 and patched once their label is bound.
+struct assembler
+{
+    std::vector<byte> code;
+
+    struct label
+    {
+        size_t position {SIZE_MAX};
+        std::vector<size_t> fixups;
+    };
+
+    std::vector<label> labels;
+
+    size_t new_label()
+    {
+        labels.emplace_back();
+        return labels.size() - 1;
+    }
+
+    void bind(size_t id)
+    {
+        labels[id].position = code.size();
+    }
+
+    void emit(std::initializer_list<byte> bytes)
+    {
+        code.insert(code.end(), bytes);
+    }
+
+    void emit32(uint32_t value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            code.push_back(static_cast<byte>(value >> (8 * i)));
+    }
+
+    void emit64(uint64_t value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            code.push_back(static_cast<byte>(value >> (8 * i)));
+    }
+
+    void jump(size_t id)
+    {
+        emit({0xE9});
+        labels[id].fixups.push_back(code.size());
+        emit32(0);
+    }
+
+    void jump_if(condition cc, size_t id)
+    {
+        emit({0x0F, static_cast<byte>(0x80 | cc)});
+        labels[id].fixups.push_back(code.size());
+        emit32(0);
+    }
+
+    void finish()
+    {
+        for (const label& l : labels)
+        {
+            for (size_t fixup : l.fixups)
+            {
+                const uint32_t rel = static_cast<uint32_t>(l.position - (fixup + 4));
+                std::memcpy(&code[fixup], &rel, sizeof(rel));
+            }
+        }
+    }
+};
+
+// Compares the candidate at r9 against every non-wildcard byte and jumps to fail on the first difference.
+static void emit_verify(assembler& a, const compiled_pattern& pattern, size_t fail)
+{
+    const byte* bytes = pattern.pattern();
+    const byte* masks = pattern.byte_masks();
+    const size_t length = pattern.size();
+
+    for (size_t i = 0; i < length;)
+    {
+        if (masks[i] == 0x00)
+        {
+            ++i;
+            continue;
+        }
+
+        if (masks[i] != 0xFF)
+        {
+            a.emit({0x45, 0x0F, 0xB6, 0x91}); // movzx r10d, byte [r9 + disp32]
+            a.emit32(static_cast<uint32_t>(i));
+            a.emit({0x41, 0x81, 0xE2}); // and r10d, imm32
+            a.emit32(masks[i]);
+            a.emit({0x41, 0x81, 0xFA}); // cmp r10d, imm32
+            a.emit32(bytes[i] & masks[i]);
+            a.jump_if(cc_not_equal, fail);
+            ++i;
+            continue;
+        }
+
+        size_t run = 0;
+        while (i + run < length && masks[i + run] == 0xFF)
+            ++run;
+
+        while (run != 0)
+        {
+            if (run >= 8)
+            {
+                uint64_t value;
+                std::memcpy(&value, bytes + i, sizeof(value));
+                a.emit({0x49, 0xBA}); // mov r10, imm64
+                a.emit64(value);
+                a.emit({0x4D, 0x39, 0x91}); // cmp [r9 + disp32], r10
+                a.emit32(static_cast<uint32_t>(i));
+                i += 8;
+                run -= 8;
+            }
+            else if (run >= 4)
+            {
+                uint32_t value;
+                std::memcpy(&value, bytes + i, sizeof(value));
+                a.emit({0x41, 0x81, 0xB9}); // cmp dword [r9 + disp32], imm32
+                a.emit32(static_cast<uint32_t>(i));
+                a.emit32(value);
+                i += 4;
+                run -= 4;
+            }
+            else if (run >= 2)
+            {
+                a.emit({0x66, 0x41, 0x81, 0xB9}); // cmp word [r9 + disp32], imm16
+                a.emit32(static_cast<uint32_t>(i));
+                a.emit({bytes[i], bytes[i + 1]});
+                i += 2;
+                run -= 2;
+            }
+            else
+            {
+                a.emit({0x41, 0x80, 0xB9}); // cmp byte [r9 + disp32], imm8
+                a.emit32(static_cast<uint32_t>(i));
+                a.emit({bytes[i]});
+                i += 1;
+                run -= 1;
+            }
+
+            a.jump_if(cc_not_equal, fail);
+        }
+    }
+
+    a.emit({0x4C, 0x89, 0xC8}); // mov rax, r9
+    a.emit({0xC3});             // ret
+}
+
+// Sets xmm_reg (0 or 3) to 16 copies of value.
+static void emit_broadcast(assembler& a, byte xmm_reg, byte value)
+{
+    a.emit({0xB9}); // mov ecx, imm32
+    a.emit32(value * 0x01010101u);
+    a.emit({0x66, 0x0F, 0x6E, static_cast<byte>(0xC1 | (xmm_reg << 3))}); // movd xmm, ecx
+    a.emit({0x66, 0x0F, 0x70, static_cast<byte>(0xC0 | (xmm_reg << 3) | xmm_reg), 0x00}); // pshufd xmm, xmm, 0
+}
+
+// Only volatile registers of both calling conventions are used: rax (cursor), rdx (last), rcx and r8-r10, xmm0-xmm3.
+static std::vector<byte> generate(const compiled_pattern& pattern)
+{
+    assembler a;
+
+    const size_t length = pattern.size();
+    const byte* masks = pattern.byte_masks();
+
+    size_t first = SIZE_MAX;
+    size_t last = SIZE_MAX;
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (masks[i] != 0xFF)
+            continue;
+
+        if (first == SIZE_MAX)
+            first = i;
+        last = i;
+    }
+
+#  if defined(_WIN32)
+    a.emit({0x48, 0x89, 0xC8}); // mov rax, rcx
+#  else
+    a.emit({0x48, 0x89, 0xF8}); // mov rax, rdi
+    a.emit({0x48, 0x89, 0xF2}); // mov rdx, rsi
+#  endif
+
+    const size_t scalar_loop = a.new_label();
+    const size_t scalar_next = a.new_label();
+    const size_t not_found = a.new_label();
+
+    if (first != SIZE_MAX)
+    {
+        const size_t vector_loop = a.new_label();
+        const size_t vector_next = a.new_label();
+        const size_t bit_loop = a.new_label();
+        const size_t bit_next = a.new_label();
+
+        emit_broadcast(a, 0, pattern.pattern()[first]);
+        emit_broadcast(a, 3, pattern.pattern()[last]);
+
+        // Candidates rax..rax+15 read up to rax + last + 15, which stays inside the region while rax + 15 <= rdx.
+        a.bind(vector_loop);
+        a.emit({0x48, 0x8D, 0x48, 0x0F}); // lea rcx, [rax + 15]
+        a.emit({0x48, 0x39, 0xD1});       // cmp rcx, rdx
+        a.jump_if(cc_above, scalar_loop);
+        a.emit({0xF3, 0x0F, 0x6F, 0x88}); // movdqu xmm1, [rax + disp32]
+        a.emit32(static_cast<uint32_t>(first));
+        a.emit({0x66, 0x0F, 0x74, 0xC8}); // pcmpeqb xmm1, xmm0
+        a.emit({0xF3, 0x0F, 0x6F, 0x90}); // movdqu xmm2, [rax + disp32]
+        a.emit32(static_cast<uint32_t>(last));
+        a.emit({0x66, 0x0F, 0x74, 0xD3}); // pcmpeqb xmm2, xmm3
+        a.emit({0x66, 0x0F, 0xDB, 0xCA}); // pand xmm1, xmm2
+        a.emit({0x66, 0x0F, 0xD7, 0xC9}); // pmovmskb ecx, xmm1
+        a.emit({0x85, 0xC9});             // test ecx, ecx
+        a.jump_if(cc_equal, vector_next);
+
+        a.bind(bit_loop);
+        a.emit({0x44, 0x0F, 0xBC, 0xC1}); // bsf r8d, ecx
+        a.emit({0x4E, 0x8D, 0x0C, 0x00}); // lea r9, [rax + r8]
+        emit_verify(a, pattern, bit_next);
+
+        a.bind(bit_next);
+        a.emit({0x44, 0x8D, 0x41, 0xFF}); // lea r8d, [rcx - 1]
+        a.emit({0x44, 0x21, 0xC1});       // and ecx, r8d
+        a.jump_if(cc_not_equal, bit_loop);
+
+        a.bind(vector_next);
+        a.emit({0x48, 0x83, 0xC0, 0x10}); // add rax, 16
+        a.jump(vector_loop);
+    }
+
+    a.bind(scalar_loop);
+    a.emit({0x48, 0x39, 0xD0}); // cmp rax, rdx
+    a.jump_if(cc_above, not_found);
+
+    if (first != SIZE_MAX)
+    {
+        a.emit({0x80, 0xB8}); // cmp byte [rax + disp32], imm8
+        a.emit32(static_cast<uint32_t>(first));
+        a.emit({pattern.pattern()[first]});
+        a.jump_if(cc_not_equal, scalar_next);
+    }
+
+    a.emit({0x49, 0x89, 0xC1}); // mov r9, rax
+    emit_verify(a, pattern, scalar_next);
+
+    a.bind(scalar_next);
+    a.emit({0x48, 0xFF, 0xC0}); // inc rax
+    a.jump(scalar_loop);
+
+    a.bind(not_found);
+    a.emit({0x31, 0xC0}); // xor eax, eax
+    a.emit({0xC3});       // ret
+
+    a.finish();
+    return std::move(a.code);
+}
+
+// Appends one line per function to /tmp/perf-<pid>.map, the format perf and friends read for JIT code.
+static void register_perf_symbol(const void* code, size_t size, const compiled_pattern& pattern)
+{
+#  if defined(__linux__)
+    static std::FILE* const map = [] {
+        char path[64];
+        std::snprintf(path, sizeof(path), "/tmp/perf-%d.map", static_cast<int>(getpid()));
+        return std::fopen(path, "a");
+    }();
+
+    if (!map)
+        return;
+
+    std::fprintf(map, "%zx %zx jit_pattern_", reinterpret_cast<size_t>(code), size);
+    for (size_t i = 0; i < pattern.size() && i < 16; ++i)
+    {
+        if (pattern.byte_masks()[i] == 0x00)
+            std::fputs("??", map);
+        else
+            std::fprintf(map, "%02X", pattern.pattern()[i]);
+    }
+    std::fputc('\n', map);
+    std::fflush(map);
+#  else
+    (void) code;
+    (void) size;
+    (void) pattern;
+#  endif
+}
+
+struct compiled_jit : compiled_pattern
+{
+    void* pages {nullptr};
+    size_t page_bytes {0};
+    find_next_fn find_next {nullptr};
+
+    compiled_jit(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_jit(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    ~compiled_jit() override
+    {
+        mem::protect_free(pages, page_bytes);
+    }
+
+    compiled_jit(const compiled_jit&) = delete;
+    compiled_jit& operator=(const compiled_jit&) = delete;
+
+    void init()
+    {
+        const std::vector<byte> code = generate(*this);
+        const size_t page_size = mem::page_size();
+
+        page_bytes = (code.size() + page_size - 1) / page_size * page_size;
+        pages = mem::protect_alloc(page_bytes, mem::prot_flags::RW);
+        if (!pages)
+            throw std::bad_alloc();
+
+        std::memcpy(pages, code.data(), code.size());
+        if (!mem::protect_modify(pages, page_bytes, mem::prot_flags::RX))
+            throw std::runtime_error("JIT pages could not be made executable");
+
+        find_next = reinterpret_cast<find_next_fn>(pages);
+        register_perf_symbol(pages, code.size(), *this);
+    }
+};
+} // namespace jit_impl
+
+struct jit_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<jit_impl::compiled_jit>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<jit_impl::compiled_jit>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const auto& compiled = static_cast<const jit_impl::compiled_jit&>(pattern);
+        if (compiled.size() == 0 || compiled.size() > length)
+            return;
+
+        const byte* const last = data + length - compiled.size();
+        for (const byte* cursor = data; cursor <= last;)
+        {
+            const byte* match = compiled.find_next(cursor, last);
+            if (!match || !results.push(match))
+                return;
+
+            cursor = match + 1;
+        }
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "JIT (x86-64)";
+    }
+};
+
+REGISTER_PATTERN(jit_pattern_scanner);
+
+#endif
@@ -0,0 +1,410 @@
+// Filters candidates on the rarest 2 to 4 pattern bytes before verifying them.
+//
+// Every fixed pattern byte and every pair of adjacent exact bytes is ranked by how often it occurs in the data being
+// scanned. The counts come from a byte and byte-pair table over a sample of the region, like Pattern16's
+// getFrequencies16 but measured per scan, so data flooded with a byte that a fixed table calls rare is ranked
+// correctly. A pair is ranked on its own count, so two bytes that nearly always occur together do not pass as two
+// independent filters. The anchors are picked greedily at any offset, and each step ANDs one AVX2 compare per anchor
+// over 32 candidates, so only candidates that pass all of them are verified. Regions too small to be worth sampling use
+// the ranking made at compile time from a prior of common x86 bytes.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <immintrin.h>
+#include <vector>
+
+namespace k_anchor_impl
+{
+static constexpr size_t max_anchors = 4;
+
+// Regions at least this long are sampled. Below it, the sample costs about as much as the scan it would speed up.
+static constexpr size_t sample_min_length = 256 * 1024;
+
+// The sample is sample_blocks blocks of sample_block bytes, spread evenly over the region.
+static constexpr size_t sample_blocks = 64;
+static constexpr size_t sample_block = 64;
+
+// Weight of the prior against the sample, in sampled bytes.
+static constexpr double prior_weight = 64.0;
+
+// Anchors stop being added once the expected share of candidates that pass them all drops below this. A further compare
+// costs about as much as the verifications it would still save.
+static constexpr double stop_rate = 1.0 / 256;
+
+// Prior probability of each byte value, from commonness.
+static const std::array<double, 256>& prior()
+{
+    static const std::array<double, 256> table = [] {
+        std::array<double, 256> out {};
+        double total = 0.0;
+
+        for (size_t i = 0; i < 256; ++i)
+        {
+            const double rank = commonness(static_cast<byte>(i));
+            out[i] = 1.0 + rank * rank;
+            total += out[i];
+        }
+
+        for (double& p : out)
+            p /= total;
+
+        return out;
+    }();
+
+    return table;
+}
+
+// One masked byte compare, at a pattern offset.
+struct anchor
+{
+    size_t offset;
+    byte value;
+    byte mask;
+};
+
+struct anchor_set
+{
+    anchor anchors[max_anchors] {};
+    size_t count {0};
+    bool masked {false}; // Some anchor has wildcard bits.
+};
+
+// Byte and byte-pair counts over a sample. pairs is indexed by first | second << 8. Both are null for no sample.
+struct sample_counts
+{
+    const uint32_t* bytes {nullptr};
+    const uint16_t* pairs {nullptr};
+    size_t total {0};
+};
+
+// Share of data bytes equal to value under mask.
+static double byte_rate(const sample_counts& counts, byte value, byte mask)
+{
+    const std::array<double, 256>& p = prior();
+
+    double count = 0.0;
+    double expected = 0.0;
+
+    if (mask == 0xFF)
+    {
+        count = counts.bytes ? counts.bytes[value] : 0.0;
+        expected = p[value];
+    }
+    else
+    {
+        for (size_t v = 0; v < 256; ++v)
+        {
+            if ((v & mask) == value)
+            {
+                count += counts.bytes ? counts.bytes[v] : 0.0;
+                expected += p[v];
+            }
+        }
+    }
+
+    return (count + prior_weight * expected) / (static_cast<double>(counts.total) + prior_weight);
+}
+
+// Share of data byte pairs equal to first, second.
+static double pair_rate(const sample_counts& counts, byte first, byte second)
+{
+    const std::array<double, 256>& p = prior();
+    const double count = counts.pairs ? counts.pairs[first | (second << 8)] : 0.0;
+
+    return (count + prior_weight * p[first] * p[second]) / (static_cast<double>(counts.total) + prior_weight);
+}
+
+struct compiled_k_anchor : compiled_pattern
+{
+    // The choice for regions that are not sampled.
+    anchor_set anchors;
+
+    compiled_k_anchor(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_k_anchor(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        rank(sample_counts {}, anchors);
+    }
+
+    // Picks the anchors that filter the most for their compares, given the counts.
+    void rank(const sample_counts& counts, anchor_set& out) const
+    {
+        // A single fixed byte (width 1) or two adjacent exact bytes (width 2).
+        struct unit
+        {
+            size_t offset;
+            size_t width;
+            double rate;
+            double score; // rate ^ (2 / width), so a pair is judged per compare. Lower filters more.
+        };
+
+        // Only the best few can be picked, so they are kept in a small sorted list instead of ranking every unit of a
+        // long pattern. Ties keep pattern order.
+        static constexpr size_t keep = max_anchors * 4;
+        std::array<unit, keep> units;
+        size_t unit_count = 0;
+
+        const auto consider = [&](const unit& candidate) {
+            if (unit_count == keep && candidate.score >= units[keep - 1].score)
+                return;
+
+            size_t j = (unit_count < keep) ? unit_count++ : keep - 1;
+            for (; j > 0 && candidate.score < units[j - 1].score; --j)
+                units[j] = units[j - 1];
+
+            units[j] = candidate;
+        };
+
+        for (size_t i = 0; i < size(); ++i)
+        {
+            if (byte_mask[i] == 0)
+                continue;
+
+            const double rate = byte_rate(counts, bytes[i], byte_mask[i]);
+            consider({i, 1, rate, rate * rate});
+
+            if (byte_mask[i] == 0xFF && i + 1 < size() && byte_mask[i + 1] == 0xFF)
+            {
+                const double joint = pair_rate(counts, bytes[i], bytes[i + 1]);
+                consider({i, 2, joint, joint});
+            }
+        }
+
+        out.count = 0;
+        out.masked = false;
+        double pass_rate = 1.0;
+
+        for (size_t u = 0; u < unit_count; ++u)
+        {
+            const unit& candidate = units[u];
+            if (out.count + candidate.width > max_anchors)
+                continue;
+
+            bool taken = false;
+            for (size_t a = 0; a < out.count; ++a)
+            {
+                const size_t offset = out.anchors[a].offset;
+                taken |= offset >= candidate.offset && offset < candidate.offset + candidate.width;
+            }
+
+            if (taken)
+                continue;
+
+            for (size_t j = candidate.offset; j < candidate.offset + candidate.width; ++j)
+            {
+                out.anchors[out.count++] = {j, bytes[j], byte_mask[j]};
+                out.masked |= byte_mask[j] != 0xFF;
+            }
+
+            // Usually two compares, but one is enough when it alone leaves next to no candidates.
+            pass_rate *= candidate.rate;
+            if (pass_rate < stop_rate && (out.count >= 2 || pass_rate < stop_rate * stop_rate))
+                break;
+        }
+    }
+};
+
+// Counts bytes and byte pairs over a sample of a region of at least sample_min_length bytes, and ranks on them.
+static void rank_sampled(const compiled_k_anchor& compiled, const byte* data, size_t length, anchor_set& out)
+{
+    // Kept zeroed between calls: each call clears the entries it counted instead of the whole 128 KiB.
+    thread_local std::vector<uint16_t> pairs(0x10000);
+    uint32_t bytes[256] {};
+
+    const size_t stride = (length - sample_block) / (sample_blocks - 1);
+
+    for (size_t b = 0; b < sample_blocks; ++b)
+    {
+        const byte* block = data + b * stride;
+        for (size_t i = 0; i + 1 < sample_block; ++i)
+        {
+            ++bytes[block[i]];
+            ++pairs[block[i] | (block[i + 1] << 8)];
+        }
+    }
+
+    compiled.rank({bytes, pairs.data(), sample_blocks * (sample_block - 1)}, out);
+
+    for (size_t b = 0; b < sample_blocks; ++b)
+    {
+        const byte* block = data + b * stride;
+        for (size_t i = 0; i + 1 < sample_block; ++i)
+            pairs[block[i] | (block[i + 1] << 8)] = 0;
+    }
+}
+
+// Match bits of the 32 candidates at block under all Count anchors. Masked is false when every anchor is exact.
+template <size_t Count, bool Masked>
+BENCH_TARGET_AVX2 static inline uint32_t block_bits(
+    const byte* block, const __m256i* values, const __m256i* masks, const size_t* offsets)
+{
+    __m256i acc = _mm256_set1_epi8(-1);
+
+    for (size_t k = 0; k < Count; ++k)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + offsets[k]));
+        if constexpr (Masked)
+            v = _mm256_and_si256(v, masks[k]);
+
+        acc = _mm256_and_si256(acc, _mm256_cmpeq_epi8(v, values[k]));
+    }
+
+    return static_cast<uint32_t>(_mm256_movemask_epi8(acc));
+}
+
+// Tests the candidates from pos on, 32 at a time while all 32 fit before last, and calls emit(candidate) for each that
+// matches. Returns the first candidate it did not cover, or SIZE_MAX if emit returned false.
+template <size_t Count, bool Masked, typename Emit>
+BENCH_TARGET_AVX2 static size_t scan_blocks(
+    const compiled_k_anchor& compiled, const anchor_set& set, const byte* data, size_t pos, size_t last, Emit&& emit)
+{
+    __m256i values[Count];
+    __m256i masks[Count];
+    size_t offsets[Count];
+
+    for (size_t k = 0; k < Count; ++k)
+    {
+        values[k] = _mm256_set1_epi8(static_cast<char>(set.anchors[k].value));
+        masks[k] = _mm256_set1_epi8(static_cast<char>(set.anchors[k].mask));
+        offsets[k] = set.anchors[k].offset;
+    }
+
+    const auto verify = [&](size_t block, uint64_t bits) {
+        for (; bits; bits &= bits - 1)
+        {
+            const byte* candidate = data + block + static_cast<size_t>(std::countr_zero(bits));
+            if (compiled.matches(candidate) && !emit(candidate))
+                return false;
+        }
+        return true;
+    };
+
+    // Two blocks per step, so the common no-candidate case costs one branch per 64 bytes.
+    for (; pos + 63 <= last; pos += 64)
+    {
+        const uint64_t bits = block_bits<Count, Masked>(data + pos, values, masks, offsets) |
+            (uint64_t(block_bits<Count, Masked>(data + pos + 32, values, masks, offsets)) << 32);
+
+        if (bits && !verify(pos, bits))
+            return SIZE_MAX;
+    }
+
+    for (; pos + 31 <= last; pos += 32)
+    {
+        if (!verify(pos, block_bits<Count, Masked>(data + pos, values, masks, offsets)))
+            return SIZE_MAX;
+    }
+
+    return pos;
+}
+
+template <bool Masked, typename Emit>
+static size_t scan_anchors(
+    const compiled_k_anchor& compiled, const anchor_set& set, const byte* data, size_t pos, size_t last, Emit&& emit)
+{
+    switch (set.count)
+    {
+        case 1:
+            return scan_blocks<1, Masked>(compiled, set, data, pos, last, emit);
+        case 2:
+            return scan_blocks<2, Masked>(compiled, set, data, pos, last, emit);
+        case 3:
+            return scan_blocks<3, Masked>(compiled, set, data, pos, last, emit);
+        case 4:
+            return scan_blocks<4, Masked>(compiled, set, data, pos, last, emit);
+    }
+
+    return pos;
+}
+
+static void scan(const compiled_k_anchor& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    anchor_set sampled;
+    const anchor_set* set = &compiled.anchors;
+
+    if (length >= sample_min_length)
+    {
+        rank_sampled(compiled, data, length, sampled);
+        set = &sampled;
+    }
+
+    const size_t last = length - m;
+    const auto emit = [&](const byte* candidate) { return results.push(candidate); };
+
+    // Candidates before the rarest anchor's loads reach a 32-byte boundary are checked one by one, so those loads
+    // never split a cache line. Without anchors, the whole region is.
+    const size_t head = set->count
+        ? (std::min)((0 - reinterpret_cast<uintptr_t>(data + set->anchors[0].offset)) & 31, last + 1)
+        : last + 1;
+
+    size_t pos = 0;
+    for (; pos < head; ++pos)
+    {
+        if (compiled.matches(data + pos) && !results.push(data + pos))
+            return;
+    }
+
+    pos = set->masked ? scan_anchors<true>(compiled, *set, data, pos, last, emit)
+                      : scan_anchors<false>(compiled, *set, data, pos, last, emit);
+
+    if (pos == SIZE_MAX)
+        return;
+
+    for (; pos <= last; ++pos)
+    {
+        if (compiled.matches(data + pos) && !results.push(data + pos))
+            return;
+    }
+}
+} // namespace k_anchor_impl
+
+struct k_anchor_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<k_anchor_impl::compiled_k_anchor>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<k_anchor_impl::compiled_k_anchor>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        k_anchor_impl::scan(static_cast<const k_anchor_impl::compiled_k_anchor&>(pattern), data, length, results);
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "K-Anchor (AVX2)";
+    }
+};
+
+REGISTER_PATTERN(k_anchor_pattern_scanner);
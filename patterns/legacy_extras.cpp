@@ -36,12 +36,21 @@ static const byte* find_first(const byte* begin, const byte* end, const std::vec
     return (it == end) ? nullptr : it;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
 {
-    std::vector<const byte*> results;
-    const std::vector<std::pair<byte, bool>> pat = build_pattern(pattern, mask);
+    std::vector<std::pair<byte, bool>> pat;
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pat(build_pattern(pattern, mask))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
+{
+    const std::vector<std::pair<byte, bool>>& pat = compiled.pat;
     if (pat.empty() || pat.size() > length)
-        return results;
+        return;
 
     const byte* begin = data;
     const byte* const end = data + length;
@@ -51,20 +60,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         begin = found + 1;
     }
-
-    return results;
 }
 } // namespace atom0s_impl
 
 struct atom0s_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<atom0s_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return atom0s_impl::find_all(data, length, pattern, mask);
+        atom0s_impl::find_all(data, length, static_cast<const atom0s_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -178,14 +191,23 @@ static const byte* find_first(const byte* begin, const byte* end, const std::vec
     return (it == end) ? nullptr : it;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
 {
-    std::vector<const byte*> results;
-    const std::string pattern_text = MakeCompactHexPattern(pattern, mask);
-
     std::vector<PatternByte> pat;
-    if (!transform_pattern(pattern_text, pat) || pat.size() > length)
-        return results;
+    bool valid {false};
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        valid = transform_pattern(MakeCompactHexPattern(pattern, mask), pat);
+    }
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
+{
+    const std::vector<PatternByte>& pat = compiled.pat;
+    if (!compiled.valid || pat.size() > length)
+        return;
 
     const byte* begin = data;
     const byte* const end = data + length;
@@ -195,20 +217,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         begin = found + 1;
     }
-
-    return results;
 }
 } // namespace atom0s_mrexodia_impl
 
 struct atom0s_mrexodia_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
     {
-        return atom0s_mrexodia_impl::find_all(data, length, pattern, mask);
+        return std::make_unique<atom0s_mrexodia_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        atom0s_mrexodia_impl::find_all(data, length, static_cast<const atom0s_mrexodia_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -267,14 +293,23 @@ static const byte* find_first(const byte* range_start, const byte* range_end, co
     return nullptr;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
+{
+    std::string pattern_text;
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pattern_text(MakeSpacedHexPattern(pattern, mask, false))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
+    const size_t pattern_length = compiled.size();
     if (pattern_length == 0 || pattern_length > length)
-        return results;
+        return;
 
-    const std::string pattern_text = MakeSpacedHexPattern(pattern, mask, false);
+    const std::string& pattern_text = compiled.pattern_text;
 
     size_t base = 0;
     while (base < length)
@@ -283,20 +318,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace learn_more_impl
 
 struct learn_more_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
     {
-        return learn_more_impl::find_all(data, length, pattern, mask);
+        return std::make_unique<learn_more_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        learn_more_impl::find_all(data, length, static_cast<const learn_more_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -361,14 +400,23 @@ static const byte* find_first(const byte* range_start, size_t len, const char* p
     return nullptr;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
+{
+    std::string pattern_text;
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pattern_text(MakeSpacedHexPattern(pattern, mask, false))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
+    const size_t pattern_length = compiled.size();
     if (pattern_length == 0 || pattern_length > length)
-        return results;
+        return;
 
-    const std::string pattern_text = MakeSpacedHexPattern(pattern, mask, false);
+    const std::string& pattern_text = compiled.pattern_text;
 
     size_t base = 0;
     while (base < length)
@@ -377,20 +425,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace learn_more_v2_impl
 
 struct learn_more_v2_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<learn_more_v2_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return learn_more_v2_impl::find_all(data, length, pattern, mask);
+        learn_more_v2_impl::find_all(data, length, static_cast<const learn_more_v2_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -437,14 +489,23 @@ static const byte* find_first(const byte* base, size_t size, const std::string&
     return nullptr;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
+{
+    std::string pattern_text;
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pattern_text(MakeSpacedHexPattern(pattern, mask, true))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
+    const size_t pattern_length = compiled.size();
     if (pattern_length == 0 || pattern_length > length)
-        return results;
+        return;
 
-    const std::string pattern_text = MakeSpacedHexPattern(pattern, mask, true);
+    const std::string& pattern_text = compiled.pattern_text;
 
     size_t base = 0;
     while (base < length)
@@ -453,20 +514,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace mike_impl
 
 struct mike_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<mike_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return mike_impl::find_all(data, length, pattern, mask);
+        mike_impl::find_all(data, length, static_cast<const mike_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -524,14 +589,23 @@ static ptrdiff_t find_first(const char* signature, const byte* data, size_t data
     return -1;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
+{
+    std::string pattern_text;
+
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pattern_text(MakeSpacedHexPattern(pattern, mask, false))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
+    const size_t pattern_length = compiled.size();
     if (pattern_length == 0 || pattern_length > length)
-        return results;
+        return;
 
-    const std::string pattern_text = MakeSpacedHexPattern(pattern, mask, false);
+    const std::string& pattern_text = compiled.pattern_text;
 
     size_t base = 0;
     while (base < length)
@@ -541,20 +615,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
             break;
 
         const byte* found = data + base + offset;
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace stevemk14ebr_impl
 
 struct stevemk14ebr_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<stevemk14ebr_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return stevemk14ebr_impl::find_all(data, length, pattern, mask);
+        stevemk14ebr_impl::find_all(data, length, static_cast<const stevemk14ebr_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -595,12 +673,13 @@ static const byte* find_first(const byte* base, const byte* pattern, const char*
     return nullptr;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void find_all(const byte* data, size_t length, const compiled_pattern& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
+    const byte* pattern = compiled.pattern();
+    const char* mask = compiled.masks();
+    const size_t pattern_length = compiled.size();
     if (pattern_length == 0 || pattern_length > length)
-        return results;
+        return;
 
     size_t base = 0;
     while (base < length)
@@ -609,20 +688,19 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace superdoc1234_impl
 
 struct superdoc1234_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return superdoc1234_impl::find_all(data, length, pattern, mask);
+        superdoc1234_impl::find_all(data, length, pattern, results);
     }
 
     virtual const char* GetName() const override
@@ -660,19 +738,27 @@ static const byte* find_first(const byte* base, size_t image_size, const byte* p
     return nullptr;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct compiled : compiled_pattern
 {
-    std::vector<const byte*> results;
-    const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return results;
+    std::vector<byte> transformed;
 
-    std::vector<byte> transformed(pattern, pattern + pattern_length);
-    for (size_t i = 0; i < pattern_length; ++i)
+    compiled(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , transformed(pattern, pattern + size())
     {
-        if (mask[i] == '?')
-            transformed[i] = static_cast<byte>(0xCC);
+        for (size_t i = 0; i < transformed.size(); ++i)
+        {
+            if (mask[i] == '?')
+                transformed[i] = static_cast<byte>(0xCC);
+        }
     }
+};
+
+static void find_all(const byte* data, size_t length, const compiled& compiled, match_sink& results)
+{
+    const std::vector<byte>& transformed = compiled.transformed;
+    if (transformed.empty() || transformed.size() > length)
+        return;
 
     size_t base = 0;
     while (base < length)
@@ -681,20 +767,24 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>(found - data) + 1;
     }
-
-    return results;
 }
 } // namespace trippeh_v2_impl
 
 struct trippeh_v2_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<trippeh_v2_impl::compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return trippeh_v2_impl::find_all(data, length, pattern, mask);
+        trippeh_v2_impl::find_all(data, length, static_cast<const trippeh_v2_impl::compiled&>(pattern), results);
     }
 
     virtual const char* GetName() const override
@@ -69,6 +69,17 @@ static pattern_signature make_signature(const byte* pattern, const char* mask)
     return sig;
 }
 
+static pattern_signature make_signature(const byte* pattern, const byte* byte_masks, size_t size)
+{
+    pattern_signature sig;
+    sig.reserve(size);
+
+    for (size_t i = 0; i < size; ++i)
+        sig.push_back(signature_element(pattern[i], byte_masks[i]));
+
+    return sig;
+}
+
 static std::pair<size_t, pattern_signature> truncate(const pattern_signature& sig)
 {
     size_t offset = 0;
@@ -91,6 +102,28 @@ static const byte* find_pattern_single(const byte* begin, const byte* end, const
     const byte firstByte = sig[0].value();
     const byte* const scanEnd = end - sig.size() + 1;
 
+    // A partial first byte (e.g. a nibble mask) cannot drive std::find, so test every start instead.
+    if (!sig[0].all())
+    {
+        for (const byte* i = begin; i != scanEnd; ++i)
+        {
+            bool match = true;
+            for (size_t j = 0; j < sig.size(); ++j)
+            {
+                if (!(sig[j] == i[j]))
+                {
+                    match = false;
+                    break;
+                }
+            }
+
+            if (match)
+                return i;
+        }
+
+        return nullptr;
+    }
+
     for (const byte* i = begin; i != scanEnd; ++i)
     {
         i = std::find(i, scanEnd, firstByte);
@@ -114,14 +147,28 @@ static const byte* find_pattern_single(const byte* begin, const byte* end, const
     return nullptr;
 }
 
-static std::vector<const byte*> find_all_pattern(
-    const byte* begin, const byte* end, const pattern_signature& sig)
+struct compiled_signature : compiled_pattern
+{
+    std::pair<size_t, pattern_signature> truncated;
+
+    compiled_signature(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , truncated(truncate(make_signature(pattern, mask)))
+    {}
+
+    compiled_signature(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+        , truncated(truncate(make_signature(pattern, byte_masks, length)))
+    {}
+};
+
+static void find_all_pattern(const byte* begin, const byte* end, const compiled_signature& sig, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const std::pair<size_t, pattern_signature> truncated = truncate(sig);
+    const size_t offset = sig.truncated.first;
+    const pattern_signature& trunc = sig.truncated.second;
 
-    const size_t offset = truncated.first;
-    const pattern_signature& trunc = truncated.second;
+    if (offset == sig.size())
+        return;
 
     const byte* i = begin + static_cast<ptrdiff_t>(offset);
     while (i < end && trunc.size() <= static_cast<size_t>(end - i))
@@ -131,29 +178,44 @@ static std::vector<const byte*> find_all_pattern(
             break;
 
         const byte* addr = result - static_cast<ptrdiff_t>(offset);
-        results.push_back(addr);
+        if (!results.push(addr))
+            return;
         i = result + 1;
     }
-
-    return results;
-}
-
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
-{
-    const pattern_signature sig = make_signature(pattern, mask);
-    if (sig.empty())
-        return {};
-
-    return find_all_pattern(data, data + length, sig);
 }
 } // namespace libhat_impl
 
 struct libhat_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
     {
-        return libhat_impl::find_all(data, length, pattern, mask);
+        return std::make_unique<libhat_impl::compiled_signature>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<libhat_impl::compiled_signature>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        libhat_impl::find_all_pattern(
+            data, data + length, static_cast<const libhat_impl::compiled_signature&>(pattern), results);
+    }
+
+    virtual const byte* ScanFirst(const compiled_pattern& pattern, const byte* data, size_t length) const override
+    {
+        const libhat_impl::compiled_signature& sig = static_cast<const libhat_impl::compiled_signature&>(pattern);
+        const size_t offset = sig.truncated.first;
+
+        if (offset == sig.size() || length < sig.size())
+            return nullptr;
+
+        const byte* result = libhat_impl::find_pattern_single(data + offset, data + length, sig.truncated.second);
+
+        return result ? (result - offset) : nullptr;
     }
 
     virtual const char* GetName() const override
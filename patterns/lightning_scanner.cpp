@@ -43,6 +43,23 @@ static Pattern ParsePattern(const byte* pattern, const char* mask)
     return out;
 }
 
+static Pattern ParsePattern(const byte* pattern, const byte* byte_masks, size_t len)
+{
+    Pattern out;
+
+    out.data.resize(len);
+    out.mask.resize(len);
+    out.unpaddedSize = len;
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        out.data[i] = pattern[i] & byte_masks[i];
+        out.mask[i] = byte_masks[i];
+    }
+
+    return out;
+}
+
 static const byte* FindStdFind(const Pattern& data, const byte* startAddr, size_t size)
 {
     if (data.unpaddedSize == 0 || size < data.unpaddedSize)
@@ -51,7 +68,7 @@ static const byte* FindStdFind(const Pattern& data, const byte* startAddr, size_
     const byte* start = startAddr;
     const byte* end = startAddr + size - data.unpaddedSize + 1;
 
-    if (data.mask[0] == 0x00)
+    if (data.mask[0] != 0xFF)
     {
         while (start != end)
         {
@@ -102,13 +119,25 @@ static const byte* FindStdFind(const Pattern& data, const byte* startAddr, size_
     return nullptr;
 }
 
-static std::vector<const byte*> FindAll(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct CompiledPattern : compiled_pattern
 {
-    std::vector<const byte*> results;
-    const Pattern parsed = ParsePattern(pattern, mask);
+    Pattern parsed;
 
+    CompiledPattern(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , parsed(ParsePattern(pattern, mask))
+    {}
+
+    CompiledPattern(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+        , parsed(ParsePattern(pattern, byte_masks, length))
+    {}
+};
+
+static void FindAll(const byte* data, size_t length, const Pattern& parsed, match_sink& results)
+{
     if (parsed.unpaddedSize == 0 || length < parsed.unpaddedSize)
-        return results;
+        return;
 
     size_t base = 0;
     while (base < length)
@@ -117,20 +146,37 @@ static std::vector<const byte*> FindAll(const byte* data, size_t length, const b
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>((found - data) + 1);
     }
-
-    return results;
 }
 } // namespace lightning_scanner_impl
 
 struct lightning_scanner_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<lightning_scanner_impl::CompiledPattern>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<lightning_scanner_impl::CompiledPattern>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        lightning_scanner_impl::FindAll(
+            data, length, static_cast<const lightning_scanner_impl::CompiledPattern&>(pattern).parsed, results);
+    }
+
+    virtual const byte* ScanFirst(const compiled_pattern& pattern, const byte* data, size_t length) const override
     {
-        return lightning_scanner_impl::FindAll(data, length, pattern, mask);
+        return lightning_scanner_impl::FindStdFind(
+            static_cast<const lightning_scanner_impl::CompiledPattern&>(pattern).parsed, data, length);
     }
 
     virtual const char* GetName() const override
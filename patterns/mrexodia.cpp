@@ -5,24 +5,27 @@
 #include <algorithm>
 #include <cstring>
 
-// Wildcard-aware Boyer-Moore-Horspool variant that remains exhaustive.
-static std::vector<const byte*> find_masked(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void fill_last_table(const byte* pattern, const char* mask, ptrdiff_t* last)
 {
     const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return {};
-
-    ptrdiff_t last[UCHAR_MAX + 1];
     const char* wild = std::strrchr(mask, '?');
-    std::fill(std::begin(last), std::end(last), wild ? (wild - mask) : -1);
+    std::fill(last, last + UCHAR_MAX + 1, wild ? (wild - mask) : -1);
 
     for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(pattern_length); ++i)
     {
         if (mask[i] == 'x' && last[pattern[i]] < i)
             last[pattern[i]] = i;
     }
+}
+
+// Wildcard-aware Boyer-Moore-Horspool variant that remains exhaustive.
+static void find_masked(const byte* data, size_t length, const byte* pattern, const char* mask, const ptrdiff_t* last,
+    match_sink& results)
+{
+    const size_t pattern_length = std::strlen(mask);
+    if (pattern_length == 0 || pattern_length > length)
+        return;
 
-    std::vector<const byte*> results;
     for (const byte *cursor = data, *end = data + (length - pattern_length); cursor <= end;)
     {
         ptrdiff_t i = static_cast<ptrdiff_t>(pattern_length) - 1;
@@ -31,7 +34,8 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
 
         if (i < 0)
         {
-            results.push_back(cursor);
+            if (!results.push(cursor))
+                return;
             ++cursor;
         }
         else
@@ -39,16 +43,31 @@ static std::vector<const byte*> find_masked(const byte* data, size_t length, con
             cursor += std::max<ptrdiff_t>(1, i - last[cursor[i]]);
         }
     }
-
-    return results;
 }
 
 struct mrexodia_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
+    {
+        ptrdiff_t last[UCHAR_MAX + 1];
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+        {
+            fill_last_table(pattern, mask, last);
+        }
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return find_masked(data, length, pattern, mask);
+        find_masked(
+            data, length, pattern.pattern(), pattern.masks(), static_cast<const compiled&>(pattern).last, results);
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,259 @@
+// Runs any scanner on several threads at once. See include/parallel_scanner.h.
+//
+// Slice k owns the match starts [k * slice, (k + 1) * slice) and is handed the bytes from its first start to pattern
+// length - 1 bytes past its last one. That is exactly enough for every match it owns and too short for any match
+// owned by the next slice, so each boundary hit is found by one slice only and nothing needs removing at the merge.
+
+#include "parallel_scanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace parallel_scanner
+{
+// Workers that sleep between jobs. The thread that calls run() works on the job too.
+class thread_pool
+{
+public:
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (std::thread& worker : workers_)
+            worker.join();
+    }
+
+    // Starts workers until there are at least count of them.
+    void reserve(size_t count)
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        while (workers_.size() < count)
+            workers_.emplace_back([this] { work(); });
+    }
+
+    // Runs task(i) for every i in [0, count) and returns once all of them are done. The first exception a task
+    // throws is rethrown here.
+    void run(size_t count, const std::function<void(size_t)>& task)
+    {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            count_ = count;
+            next_ = 0;
+            finished_ = 0;
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        drain(task, count);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Also wait for workers that woke up too late to claim a task, so none is left holding this job's state.
+        done_.wait(lock, [&] { return finished_ == count_ && active_ == 0; });
+        task_ = nullptr;
+
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+private:
+    void work()
+    {
+        uint64_t seen = 0;
+
+        for (;;)
+        {
+            const std::function<void(size_t)>* task = nullptr;
+            size_t count = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || (generation_ != seen && task_); });
+                if (stopping_)
+                    return;
+
+                seen = generation_;
+                task = task_;
+                count = count_;
+                ++active_;
+            }
+
+            drain(*task, count);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_;
+            }
+            done_.notify_all();
+        }
+    }
+
+    void drain(const std::function<void(size_t)>& task, size_t count)
+    {
+        size_t done = 0;
+
+        for (size_t i; (i = next_.fetch_add(1)) < count; ++done)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+
+        if (done)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                finished_ += done;
+            }
+            done_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+
+    std::mutex run_mutex_; // One job at a time.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(size_t)>* task_ {nullptr};
+    size_t count_ {0};
+    std::atomic<size_t> next_ {0};
+    size_t finished_ {0};
+    size_t active_ {0};
+    uint64_t generation_ {0};
+    bool stopping_ {false};
+    std::exception_ptr error_;
+};
+
+// One pool for every adapter, sized for the largest thread count asked for.
+static thread_pool& shared_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+struct parallel_pattern_scanner : pattern_scanner
+{
+    std::unique_ptr<pattern_scanner> inner;
+    size_t threads {1};
+    size_t min_slice {default_min_slice};
+    std::string name;
+
+    parallel_pattern_scanner(std::unique_ptr<pattern_scanner> inner_scanner, size_t thread_count, size_t slice_min)
+        : inner(std::move(inner_scanner))
+        , threads(thread_count)
+        , min_slice((std::max)(slice_min, size_t(1)))
+        , name(std::string("parallel(") + inner->GetName() + ")")
+    {
+        if (threads > 1)
+            shared_pool().reserve(threads - 1);
+    }
+
+    // Calls scan(slice_data, slice_length, sink) once per slice, then pushes the hits of every slice in order.
+    template <typename Scan>
+    void scan_slices(
+        const compiled_pattern& compiled, const byte* data, size_t length, match_sink& results, Scan&& scan) const
+    {
+        const size_t m = compiled.size();
+        const size_t slices = (std::min)(threads, length / min_slice);
+
+        if (slices <= 1 || m == 0 || m > length)
+        {
+            scan(data, length, results);
+            return;
+        }
+
+        // Slices start on a cache line, and on the inner scanner's required data alignment if that is stricter.
+        const size_t granule = (std::max)(inner->GetTraits().alignment, size_t(64));
+        const size_t starts = length - m + 1;
+        const size_t slice = ((starts + slices - 1) / slices + granule - 1) / granule * granule;
+        const size_t count = (starts + slice - 1) / slice;
+
+        std::vector<std::vector<const byte*>> hits(count);
+
+        shared_pool().run(count, [&](size_t k) {
+            const size_t begin = k * slice;
+            const size_t end = (std::min)(begin + slice, starts);
+
+            match_sink sink(hits[k]);
+            scan(data + begin, end - begin + m - 1, sink);
+        });
+
+        for (const std::vector<const byte*>& slice_hits : hits)
+        {
+            for (const byte* hit : slice_hits)
+            {
+                if (!results.push(hit))
+                    return;
+            }
+        }
+    }
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return inner->Compile(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return inner->CompileMasked(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        scan_slices(pattern, data, length, results, [&](const byte* slice_data, size_t slice_length, match_sink& sink) {
+            inner->ScanInto(pattern, slice_data, slice_length, sink);
+        });
+    }
+
+    virtual void ScanAlignedInto(const compiled_pattern& pattern, const byte* data, size_t length, size_t alignment,
+        match_sink& results) const override
+    {
+        scan_slices(pattern, data, length, results, [&](const byte* slice_data, size_t slice_length, match_sink& sink) {
+            inner->ScanAlignedInto(pattern, slice_data, slice_length, alignment, sink);
+        });
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        scanner_traits traits = inner->GetTraits();
+        traits.fallback = nullptr;
+        return traits;
+    }
+
+    virtual const char* GetName() const override
+    {
+        return name.c_str();
+    }
+};
+
+std::unique_ptr<pattern_scanner> wrap(std::unique_ptr<pattern_scanner> inner, size_t threads, size_t min_slice)
+{
+    return std::make_unique<parallel_pattern_scanner>(std::move(inner), threads, min_slice);
+}
+} // namespace parallel_scanner
@@ -2,112 +2,108 @@
 
 #include "pattern_entry.h"
 
-#if 0
-#include <cstring>
-#include <string>
-#include <vector>
+// Pattern16 is x86-64 only (cpuid, BMI and AVX2 intrinsics), and SIMDE has no BMI.
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(BENCH_FORCE_SIMDE)
 
-// Pattern16 is deeply x86-specific (cpuid, BMI, SSE/AVX intrinsics with
-// missing portable scanner headers).  Disabled entirely on non-x86.
-#if defined(__x86_64__) || defined(_M_X64)
+#  include <algorithm>
+#  include <array>
+#  include <bit>
+#  include <cstdint>
+#  include <cstring>
+#  include <fstream>
+#  include <map>
+#  include <memory>
+#  include <sstream>
+#  include <string>
+#  include <vector>
 
-#include <Pattern16.h>
+#  include <immintrin.h>
+
+// Pattern16 and the per-pattern setup below are built for AVX2 + BMI2. The standard headers above, which other
+// translation units share, and the registration after the pop stay baseline.
+BENCH_PUSH_TARGET_AVX2_BMI2
+
+#  include <Pattern16.h>
 
 namespace pattern16_impl
 {
-static bool has_adjacent_exact_bytes(const char* mask)
+// The split signature, the vector form and the anchor pair are built once per pattern, not once per find-first call.
+struct compiled_pattern16 : compiled_pattern
 {
-    const size_t length = std::strlen(mask);
-    if (length < 2)
-        return false;
+    Pattern16::Impl::SplitSignatureU8 split;
+    Pattern16::Impl::SplitSignature<Pattern16::Impl::Vector256> vectors;
+    size_t sig_start {0};
 
-    for (size_t i = 0; (i + 1) < length; ++i)
+    compiled_pattern16(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
     {
-        if (mask[i] == 'x' && mask[i + 1] == 'x')
-            return true;
+        init();
     }
 
-    return false;
-}
-
-static inline char hex_nibble(unsigned int value)
-{
-    return static_cast<char>((value < 10u) ? ('0' + value) : ('A' + (value - 10u)));
-}
-
-static std::string to_signature_string(const byte* pattern, const char* mask)
-{
-    const size_t length = std::strlen(mask);
-    std::string out;
-    out.reserve(length * 3);
-
-    for (size_t i = 0; i < length; ++i)
+    compiled_pattern16(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
     {
-        if (i != 0)
-            out.push_back(' ');
+        init();
+    }
 
-        if (mask[i] == '?')
-        {
-            out.push_back('?');
-            out.push_back('?');
-        }
-        else
-        {
-            const unsigned int value = static_cast<unsigned int>(pattern[i]);
-            out.push_back(hex_nibble((value >> 4) & 0xFu));
-            out.push_back(hex_nibble(value & 0xFu));
-        }
+    void init()
+    {
+        // Pattern16 masks are per bit, so partial bytes are native.
+        split.first.assign(bytes.begin(), bytes.end());
+        split.second.assign(byte_mask.begin(), byte_mask.end());
+
+        if (size() < 2)
+            return;
+
+        // Picks the rarest exact pair from Pattern16's frequency table. Patterns without two adjacent exact bytes anchor
+        // on the pair that fixes the most bits, which the kernel compares under its mask.
+        sig_start = static_cast<size_t>(Pattern16::Impl::getSigStartPos<Pattern16::Impl::BMI2>(
+            split, Pattern16::Impl::loadFrequencyCache()));
+        vectors = Pattern16::Impl::processSignatureBytes<Pattern16::Impl::Vector256>(split);
     }
+};
+} // namespace pattern16_impl
 
-    return out;
-}
+BENCH_POP_TARGET
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct pattern16_scanner : pattern_scanner
 {
-    std::vector<const byte*> results;
-
-    const size_t pattern_length = std::strlen(mask);
-    if (pattern_length == 0 || pattern_length > length)
-        return results;
-
-    // Pattern16 can miss valid matches in long regions when no adjacent exact-byte pair exists.
-    // Fall back to the reference scanner for this pattern class to keep correctness.
-    if (!has_adjacent_exact_bytes(mask))
-        return FindPatternSimple(data, length, pattern, mask);
-
-    std::string signature = to_signature_string(pattern, mask);
-    Pattern16::Impl::SplitSignatureU8 parsed = Pattern16::Impl::processSignatureString(signature);
-    if (parsed.first.empty())
-        return results;
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<pattern16_impl::compiled_pattern16>(pattern, mask);
+    }
 
-    const Pattern16::Impl::Frequencies16& frequencies = Pattern16::Impl::loadFrequencyCache();
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<pattern16_impl::compiled_pattern16>(pattern, byte_masks, length);
+    }
 
-    size_t base = 0;
-    while (base < length)
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        const size_t remaining = length - base;
-        Pattern16::Impl::SplitSignatureU8 parsed_iter = parsed;
-        const byte* found = static_cast<const byte*>(Pattern16::Impl::scan(data + base, remaining, parsed_iter, frequencies));
-        if (!found)
-            break;
+        const auto& compiled = static_cast<const pattern16_impl::compiled_pattern16&>(pattern);
+        const size_t pattern_length = compiled.size();
+        if (pattern_length == 0 || pattern_length > length)
+            return;
 
-        if (found < (data + base) || found >= (data + length))
-            break;
+        const byte* const end = data + length;
+        for (const byte* cursor = data; static_cast<size_t>(end - cursor) >= pattern_length;)
+        {
+            const void* found = (pattern_length < 2)
+                ? Pattern16::Impl::scanRegion(cursor, end, compiled.split)
+                : Pattern16::Impl::scanAVX2(cursor, end, compiled.sig_start, compiled.vectors, compiled.split);
 
-        results.push_back(found);
-        base = static_cast<size_t>(found - data) + 1;
-    }
+            if (!found || !results.push(static_cast<const byte*>(found)))
+                return;
 
-    return results;
-}
-} // namespace pattern16_impl
+            cursor = static_cast<const byte*>(found) + 1;
+        }
+    }
 
-struct pattern16_scanner : pattern_scanner
-{
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual scanner_traits GetTraits() const override
     {
-        return pattern16_impl::find_all(data, length, pattern, mask);
+        return {.isa = CPU_AVX2 | CPU_BMI1 | CPU_BMI2};
     }
 
     virtual const char* GetName() const override
@@ -118,5 +114,4 @@ struct pattern16_scanner : pattern_scanner
 
 REGISTER_PATTERN(pattern16_scanner);
 
-#endif // x86_64
-#endif
\ No newline at end of file
+#endif
@@ -37,7 +37,7 @@ static inline uint32_t trailing_zeros(uint32_t v)
 #endif
 }
 
-static const uint8_t* FindPattern(const uint8_t* baseAddress, uint64_t searchLength, const uint8_t* bytePattern,
+BENCH_TARGET_SSE42 static const uint8_t* FindPattern(const uint8_t* baseAddress, uint64_t searchLength, const uint8_t* bytePattern,
     uint32_t patternLength, const char* mask)
 {
     if (!baseAddress || !bytePattern || !mask || patternLength == 0 || searchLength < patternLength)
@@ -157,9 +157,8 @@ static const uint8_t* FindPattern(const uint8_t* baseAddress, uint64_t searchLen
     return nullptr;
 }
 
-static std::vector<const byte*> FindAll(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void FindAll(const byte* data, size_t length, const byte* pattern, const char* mask, match_sink& results)
 {
-    std::vector<const byte*> results;
     const uint32_t patternLength = static_cast<uint32_t>(std::strlen(mask));
 
     size_t base = 0;
@@ -171,20 +170,35 @@ static std::vector<const byte*> FindAll(const byte* data, size_t length, const b
             break;
 
         const byte* hit = reinterpret_cast<const byte*>(found);
-        results.push_back(hit);
+        if (!results.push(hit))
+            return;
         base = static_cast<size_t>((hit - data) + 1);
     }
-
-    return results;
 }
 } // namespace peribunt_impl
 
 struct peribunt_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        peribunt_impl::FindAll(data, length, pattern.pattern(), pattern.masks(), results);
+    }
+
+    virtual const byte* ScanFirst(const compiled_pattern& pattern, const byte* data, size_t length) const override
+    {
+        // Widened byte masks need the verified path; FindFirst alone would accept the superset.
+        if (pattern.widened)
+            return pattern_scanner::ScanFirst(pattern, data, length);
+
+        return peribunt_impl::FindPattern(data, static_cast<uint64_t>(length), pattern.pattern(),
+            static_cast<uint32_t>(pattern.size()), pattern.masks());
+    }
+
+    virtual scanner_traits GetTraits() const override
     {
-        return peribunt_impl::FindAll(data, length, pattern, mask);
+        // The 16-byte loads start at ALIGN_LOW(data, 16), up to 15 bytes before data.
+        return {.isa = CPU_SSE41 | CPU_SSE42, .overread = 15};
     }
 
     virtual const char* GetName() const override
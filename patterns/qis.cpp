@@ -2,16 +2,52 @@
 
 #include "pattern_entry.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include <immintrin.h>
+
+#if __has_include(<tbb/parallel_for.h>)
+#  include <atomic>
+#  include <tbb/parallel_for.h>
+#endif
+
+// Only the qis code is built for AVX2: the headers above, which other translation units share, stay baseline.
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)) && !defined(BENCH_FORCE_SIMDE)
+#  define QIS_SIGNATURE_USE_AVX2 1
+#endif
+
+BENCH_PUSH_TARGET_AVX2
 #include "signature.hpp"
+BENCH_POP_TARGET
 
 struct qis_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
     {
-        auto sig = qis::signature(MakeSpacedHexPattern(pattern, mask, false));
+        qis::signature sig;
 
-        std::vector<const byte*> results;
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+            , sig(MakeSpacedHexPattern(pattern, mask, false))
+        {}
+    };
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const qis::signature& sig = static_cast<const compiled&>(pattern).sig;
 
         for (size_t here = 0; here < length; ++here)
         {
@@ -21,10 +57,14 @@ struct qis_pattern_scanner : pattern_scanner
                 break;
 
             here += found;
-            results.push_back(&data[here]);
+            if (!results.push(&data[here]))
+                return;
         }
+    }
 
-        return results;
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2 | CPU_BMI1};
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,217 @@
+// Rabin-Karp over the longest exact run of the signature.
+//
+// A polynomial hash mod 2^64 rolls across the data one byte at a time, costing one multiply-add per byte whatever the
+// pattern length. This suits long signatures, such as data blobs and embedded tables, where the per-candidate work of
+// anchor scanners and the run caps of some table-driven ones start to show. A hash hit is confirmed with memcmp over
+// the run, and then the full masked pattern is verified.
+//
+// A single rolling hash is one long dependency chain, bound by multiply latency. Each round therefore rolls four
+// chains over four adjacent blocks at once. Hits in the later blocks are held back until the round ends, so results
+// still come out in address order.
+
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace rabin_karp_impl
+{
+// Odd, so multiplication is a bijection mod 2^64 and a changed byte always changes the hash.
+static constexpr uint64_t base = 0x100000001B3ull;
+
+struct compiled_rabin_karp : compiled_pattern
+{
+    size_t run_offset {0};
+    size_t run_length {0}; // 0 when the pattern has no exact byte.
+    uint64_t run_hash {0};
+    uint64_t leaving[256] {}; // Weight of a byte leaving the window: value * base^run_length.
+
+    compiled_rabin_karp(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_rabin_karp(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        for (size_t i = 0; i < size();)
+        {
+            if (byte_mask[i] != 0xFF)
+            {
+                ++i;
+                continue;
+            }
+
+            size_t run = 1;
+            while (i + run < size() && byte_mask[i + run] == 0xFF)
+                ++run;
+
+            if (run > run_length)
+            {
+                run_offset = i;
+                run_length = run;
+            }
+
+            i += run;
+        }
+
+        uint64_t base_pow = 1;
+        for (size_t i = 0; i < run_length; ++i)
+        {
+            run_hash = run_hash * base + bytes[run_offset + i];
+            base_pow *= base;
+        }
+
+        for (size_t b = 0; b < 256; ++b)
+            leaving[b] = b * base_pow;
+    }
+
+    uint64_t hash_at(const byte* window) const
+    {
+        uint64_t hash = 0;
+        for (size_t i = 0; i < run_length; ++i)
+            hash = hash * base + window[i];
+        return hash;
+    }
+
+    uint64_t roll(uint64_t hash, const byte* window) const
+    {
+        return hash * base + window[run_length] - leaving[window[0]];
+    }
+
+    bool hit(uint64_t hash, const byte* window, const byte* candidate) const
+    {
+        return hash == run_hash && std::memcmp(window, bytes.data() + run_offset, run_length) == 0 &&
+            matches(candidate);
+    }
+};
+
+static constexpr size_t chains = 4;
+
+static void scan(const compiled_rabin_karp& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    const size_t last = length - m;
+
+    if (compiled.run_length == 0)
+    {
+        for (size_t pos = 0; pos <= last; ++pos)
+        {
+            if (compiled.matches(data + pos) && !results.push(data + pos))
+                return;
+        }
+        return;
+    }
+
+    // Windows sit at the run's offset in each candidate. Blocks are long enough that hashing each block's first window
+    // stays a small share of the round.
+    const byte* const windows = data + compiled.run_offset;
+    const size_t block = (std::max)(size_t(4096), compiled.run_length * 16);
+
+    size_t pos = 0;
+    std::vector<const byte*> held[chains - 1];
+
+    // Locals, so the compiler need not reload them across the pushes.
+    const uint64_t target = compiled.run_hash;
+    const uint64_t* const leaving = compiled.leaving;
+    const size_t w = compiled.run_length;
+
+    // The last roll of a round hashes the window after the round, so that window must still fit.
+    while (last - pos >= chains * block)
+    {
+        const byte* const lane0 = windows + pos;
+        const byte* const lane1 = lane0 + block;
+        const byte* const lane2 = lane1 + block;
+        const byte* const lane3 = lane2 + block;
+
+        uint64_t h0 = compiled.hash_at(lane0);
+        uint64_t h1 = compiled.hash_at(lane1);
+        uint64_t h2 = compiled.hash_at(lane2);
+        uint64_t h3 = compiled.hash_at(lane3);
+
+        for (size_t j = 0; j < block; ++j)
+        {
+            if ((h0 == target) | (h1 == target) | (h2 == target) | (h3 == target)) [[unlikely]]
+            {
+                const uint64_t hashes[chains] {h0, h1, h2, h3};
+
+                if (compiled.hit(hashes[0], lane0 + j, data + pos + j) && !results.push(data + pos + j))
+                    return;
+
+                for (size_t k = 1; k < chains; ++k)
+                {
+                    const byte* candidate = data + pos + k * block + j;
+                    if (compiled.hit(hashes[k], windows + (candidate - data), candidate))
+                        held[k - 1].push_back(candidate);
+                }
+            }
+
+            h0 = h0 * base + lane0[j + w] - leaving[lane0[j]];
+            h1 = h1 * base + lane1[j + w] - leaving[lane1[j]];
+            h2 = h2 * base + lane2[j + w] - leaving[lane2[j]];
+            h3 = h3 * base + lane3[j + w] - leaving[lane3[j]];
+        }
+
+        for (std::vector<const byte*>& hits : held)
+        {
+            for (const byte* candidate : hits)
+            {
+                if (!results.push(candidate))
+                    return;
+            }
+            hits.clear();
+        }
+
+        pos += chains * block;
+    }
+
+    for (uint64_t hash = compiled.hash_at(windows + pos);; ++pos)
+    {
+        if (compiled.hit(hash, windows + pos, data + pos) && !results.push(data + pos))
+            return;
+
+        if (pos == last)
+            return;
+
+        hash = compiled.roll(hash, windows + pos);
+    }
+}
+} // namespace rabin_karp_impl
+
+struct rabin_karp_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<rabin_karp_impl::compiled_rabin_karp>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<rabin_karp_impl::compiled_rabin_karp>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        rabin_karp_impl::scan(static_cast<const rabin_karp_impl::compiled_rabin_karp&>(pattern), data, length, results);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Rabin-Karp";
+    }
+};
+
+REGISTER_PATTERN(rabin_karp_pattern_scanner);
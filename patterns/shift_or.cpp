@@ -0,0 +1,309 @@
+// Shift-Or (bitap) over a window of up to 64 pattern bytes.
+//
+// Bit j of the state is clear while the last j + 1 bytes match the first j + 1 window bytes. Each data byte shifts the
+// state and ORs in a per-byte column, so a wildcard costs nothing: its bit is clear in every column, and partial masks
+// are just columns with more clear bits. The state is kept high-aligned, so a match is always a clear sign bit.
+//
+// The AVX2 kernel splits each block into eight (window <= 32) or four (window <= 64) stripes. Each stripe keeps its
+// own state in one vector lane and warms up on the bytes before its start. Patterns over 64 bytes run the window with
+// the fewest wildcards as a filter and verify the whole pattern at each hit.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
+
+namespace shift_or_impl
+{
+static constexpr size_t max_window = 64;
+
+// End positions per stripe and block. Hits are buffered per stripe and emitted in order once the block is done.
+static constexpr size_t max_stripe = 4096;
+
+struct compiled_shift_or : compiled_pattern
+{
+    size_t window_offset {0};
+    size_t window_length {0};
+    bool verify {false}; // The window does not cover the whole pattern.
+
+    uint64_t columns[256] {};   // Shifted to the top of 64 bits.
+    uint32_t columns32[256] {}; // Shifted to the top of 32 bits, when the window fits.
+
+    compiled_shift_or(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_shift_or(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    void init()
+    {
+        window_length = (std::min)(size(), max_window);
+
+        if (size() > max_window)
+        {
+            size_t best = 0;
+            for (size_t offset = 0; offset + window_length <= size(); ++offset)
+            {
+                size_t exact = 0;
+                for (size_t j = 0; j < window_length; ++j)
+                    exact += static_cast<size_t>(std::popcount(byte_mask[offset + j]));
+
+                if (exact > best)
+                {
+                    best = exact;
+                    window_offset = offset;
+                }
+            }
+
+            verify = true;
+        }
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            uint64_t column = 0;
+            for (size_t j = 0; j < window_length; ++j)
+            {
+                const size_t i = window_offset + j;
+                if ((static_cast<byte>(c) & byte_mask[i]) != (bytes[i] & byte_mask[i]))
+                    column |= uint64_t(1) << j;
+            }
+
+            columns[c] = column << (max_window - window_length);
+            if (window_length <= 32)
+                columns32[c] = static_cast<uint32_t>(column << (32 - window_length));
+        }
+    }
+
+    // Initial state: every window bit set (no partial match) and the empty prefix below it clear.
+    uint64_t initial() const
+    {
+        return ~uint64_t(0) << (max_window - window_length);
+    }
+
+    uint32_t initial32() const
+    {
+        return ~uint32_t(0) << (32 - window_length);
+    }
+
+    // Turns the window end at data[end] into a pattern start, or nullptr when it does not fit or fails to verify.
+    const byte* candidate(const byte* data, size_t length, size_t end) const
+    {
+        const size_t back = window_length - 1 + window_offset;
+        if (end < back)
+            return nullptr;
+
+        const size_t start = end - back;
+        if (size() > length - start)
+            return nullptr;
+
+        if (verify && !matches(data + start))
+            return nullptr;
+
+        return data + start;
+    }
+};
+
+// Reports window ends in [begin, end), warming the state up on the bytes before begin.
+static bool scan_scalar(
+    const compiled_shift_or& compiled, const byte* data, size_t length, size_t begin, size_t end, match_sink& results)
+{
+    const size_t feed = (begin > compiled.window_length - 1) ? (begin - (compiled.window_length - 1)) : 0;
+    uint64_t state = compiled.initial();
+
+    for (size_t i = feed; i < end; ++i)
+    {
+        state = (state << 1) | compiled.columns[data[i]];
+
+        if ((state >> 63) || i < begin)
+            continue;
+
+        if (const byte* match = compiled.candidate(data, length, i); match && !results.push(match))
+            return false;
+    }
+
+    return true;
+}
+
+static bool emit_stripes(const compiled_shift_or& compiled, const byte* data, size_t length,
+    std::vector<uint32_t>* hits, size_t stripe_count, size_t block, size_t stripe, match_sink& results)
+{
+    for (size_t k = 0; k < stripe_count; ++k)
+    {
+        for (uint32_t relative : hits[k])
+        {
+            const byte* match = compiled.candidate(data, length, block + k * stripe + relative);
+            if (match && !results.push(match))
+                return false;
+        }
+
+        hits[k].clear();
+    }
+
+    return true;
+}
+
+// Eight 32-bit states. Each step gathers four data bytes per stripe, then one column per byte.
+BENCH_TARGET_AVX2 static void scan_block32(const compiled_shift_or& compiled, const byte* data, size_t block,
+    size_t stripe, size_t warm, std::vector<uint32_t>* hits)
+{
+    const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(static_cast<int>(stripe)));
+    const __m256i low_byte = _mm256_set1_epi32(0xFF);
+    const int* const columns = reinterpret_cast<const int*>(compiled.columns32);
+    const byte* const base = data + block - warm;
+
+    __m256i state = _mm256_set1_epi32(static_cast<int>(compiled.initial32()));
+
+    for (size_t i = 0; i < warm + stripe; i += 4)
+    {
+        const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + i), offsets, 1);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const __m256i index = _mm256_and_si256(_mm256_srli_epi32(words, static_cast<int>(8 * j)), low_byte);
+            state = _mm256_or_si256(_mm256_slli_epi32(state, 1), _mm256_i32gather_epi32(columns, index, 4));
+
+            uint32_t lanes = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(state))) & 0xFF;
+            if (lanes == 0 || i + j < warm)
+                continue;
+
+            for (; lanes; lanes &= lanes - 1)
+                hits[first_set_bit(lanes)].push_back(static_cast<uint32_t>(i + j - warm));
+        }
+    }
+}
+
+// Four 64-bit states for windows of 33 to 64 bytes.
+BENCH_TARGET_AVX2 static void scan_block64(const compiled_shift_or& compiled, const byte* data, size_t block,
+    size_t stripe, size_t warm, std::vector<uint32_t>* hits)
+{
+    const __m128i offsets = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int>(stripe)));
+    const __m128i low_byte = _mm_set1_epi32(0xFF);
+    const long long* const columns = reinterpret_cast<const long long*>(compiled.columns);
+    const byte* const base = data + block - warm;
+
+    __m256i state = _mm256_set1_epi64x(static_cast<long long>(compiled.initial()));
+
+    for (size_t i = 0; i < warm + stripe; i += 4)
+    {
+        const __m128i words = _mm_i32gather_epi32(reinterpret_cast<const int*>(base + i), offsets, 1);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const __m128i index = _mm_and_si128(_mm_srli_epi32(words, static_cast<int>(8 * j)), low_byte);
+            state = _mm256_or_si256(_mm256_slli_epi64(state, 1), _mm256_i32gather_epi64(columns, index, 8));
+
+            uint32_t lanes = ~static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(state))) & 0xF;
+            if (lanes == 0 || i + j < warm)
+                continue;
+
+            for (; lanes; lanes &= lanes - 1)
+                hits[first_set_bit(lanes)].push_back(static_cast<uint32_t>(i + j - warm));
+        }
+    }
+}
+
+BENCH_TARGET_AVX2 static void scan_avx2(
+    const compiled_shift_or& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const bool narrow = compiled.window_length <= 32;
+    const size_t stripe_count = narrow ? 8 : 4;
+
+    // The window length minus one, rounded up to whole gather steps.
+    const size_t warm = (compiled.window_length + 2) & ~size_t(3);
+
+    std::vector<uint32_t> hits[8];
+
+    size_t block = (std::min)(warm, length);
+    if (!scan_scalar(compiled, data, length, 0, block, results))
+        return;
+
+    while ((length - block) / stripe_count >= 4)
+    {
+        const size_t stripe = (std::min)(max_stripe, (length - block) / stripe_count) & ~size_t(3);
+
+        if (narrow)
+            scan_block32(compiled, data, block, stripe, warm, hits);
+        else
+            scan_block64(compiled, data, block, stripe, warm, hits);
+
+        if (!emit_stripes(compiled, data, length, hits, stripe_count, block, stripe, results))
+            return;
+
+        block += stripe * stripe_count;
+    }
+
+    scan_scalar(compiled, data, length, block, length, results);
+}
+} // namespace shift_or_impl
+
+struct shift_or_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<shift_or_impl::compiled_shift_or>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<shift_or_impl::compiled_shift_or>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        shift_or_impl::scan_avx2(static_cast<const shift_or_impl::compiled_shift_or&>(pattern), data, length, results);
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2, .fallback = "Shift-Or (Scalar)"};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Shift-Or (AVX2)";
+    }
+};
+
+REGISTER_PATTERN(shift_or_pattern_scanner);
+
+struct shift_or_scalar_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<shift_or_impl::compiled_shift_or>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<shift_or_impl::compiled_shift_or>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        shift_or_impl::scan_scalar(
+            static_cast<const shift_or_impl::compiled_shift_or&>(pattern), data, length, 0, length, results);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Shift-Or (Scalar)";
+    }
+};
+
+REGISTER_PATTERN(shift_or_scalar_pattern_scanner);
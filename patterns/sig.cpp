@@ -84,9 +84,8 @@ static const byte* FindFirst(const byte* buf, size_t size, const char* sig, cons
     return nullptr;
 }
 
-static std::vector<const byte*> FindAll(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void FindAll(const byte* data, size_t length, const byte* pattern, const char* mask, match_sink& results)
 {
-    std::vector<const byte*> results;
     const size_t patternLen = std::strlen(mask);
 
     size_t base = 0;
@@ -97,20 +96,29 @@ static std::vector<const byte*> FindAll(const byte* data, size_t length, const b
         if (!found)
             break;
 
-        results.push_back(found);
+        if (!results.push(found))
+            return;
         base = static_cast<size_t>((found - data) + 1);
     }
-
-    return results;
 }
 } // namespace sig_impl
 
 struct sig_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return sig_impl::FindAll(data, length, pattern, mask);
+        sig_impl::FindAll(data, length, pattern.pattern(), pattern.masks(), results);
+    }
+
+    virtual const byte* ScanFirst(const compiled_pattern& pattern, const byte* data, size_t length) const override
+    {
+        // Widened byte masks need the verified path; FindFirst alone would accept the superset.
+        if (pattern.widened)
+            return pattern_scanner::ScanFirst(pattern, data, length);
+
+        return sig_impl::FindFirst<sig_impl::Mask::Eq<'x'>, sig_impl::Mask::Any<'?'>>(
+            data, length, reinterpret_cast<const char*>(pattern.pattern()), pattern.masks(), pattern.size());
     }
 
     virtual const char* GetName() const override
@@ -5,8 +5,17 @@
 
 struct std_regex_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    struct compiled : compiled_pattern
+    {
+        std::regex pattern_reg;
+
+        compiled(const byte* pattern, const char* mask)
+            : compiled_pattern(pattern, mask)
+            , pattern_reg(MakeRegex(pattern, mask), std::regex_constants::optimize)
+        {}
+    };
+
+    static std::string MakeRegex(const byte* pattern, const char* mask)
     {
         std::string pattern_str;
 
@@ -26,9 +35,19 @@ struct std_regex_scanner : pattern_scanner
             }
         }
 
-        std::regex pattern_reg(pattern_str, std::regex_constants::optimize);
+        return pattern_str;
+    }
+
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<compiled>(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const std::regex& pattern_reg = static_cast<const compiled&>(pattern).pattern_reg;
 
-        std::vector<const byte*> results;
         std::cmatch cm;
 
         for (size_t i = 0; i < length; i += cm.position() + 1)
@@ -36,10 +55,9 @@ struct std_regex_scanner : pattern_scanner
             if (!std::regex_search((const char*) data + i, (const char*) data + length, cm, pattern_reg))
                 break;
 
-            results.push_back(data + i + cm.position());
+            if (!results.push(data + i + cm.position()))
+                break;
         }
-
-        return results;
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,220 @@
+// Portable scanner on 64-bit words, with no intrinsics.
+//
+// Eight candidates are tested per step. The 8 bytes at each of two anchor offsets are loaded as words, masked, XORed
+// with the broadcast anchor value, and reduced to one high bit per zero byte. The zero-byte test is the exact form, so
+// a borrow never flags a neighbouring lane. Surviving lanes are verified with masked 8-byte compares. This is the
+// kernel for hosts where <immintrin.h> resolves to the SIMDe shim and every AVX2 intrinsic is emulated.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace swar_impl
+{
+static constexpr uint64_t ones = 0x0101010101010101ull;
+static constexpr uint64_t lows = 0x7F7F7F7F7F7F7F7Full;
+
+static inline uint64_t load_u64(const byte* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// The high bit of every byte of v that is zero, and nothing else.
+static inline uint64_t zero_bytes(uint64_t v)
+{
+    return ~(((v & lows) + lows) | v | lows);
+}
+
+// Index of the lane that holds the lowest-addressed set high bit.
+static inline unsigned first_lane(uint64_t bits)
+{
+    if constexpr (std::endian::native == std::endian::little)
+        return static_cast<unsigned>(std::countr_zero(bits)) / 8;
+    else
+        return static_cast<unsigned>(std::countl_zero(bits)) / 8;
+}
+
+// Clears the lane returned by first_lane.
+static inline uint64_t clear_first_lane(uint64_t bits)
+{
+    if constexpr (std::endian::native == std::endian::little)
+        return bits & (bits - 1);
+    else
+        return bits & ~(uint64_t(1) << (63 - std::countl_zero(bits)));
+}
+
+// One masked compare of 8 pattern bytes, in memory order.
+struct word_check
+{
+    size_t offset;
+    uint64_t value;
+    uint64_t mask;
+};
+
+struct compiled_swar : compiled_pattern
+{
+    // Pattern offsets of the two anchor bytes. They are equal when the pattern has one non-wildcard byte.
+    size_t anchor_a {0};
+    size_t anchor_b {0};
+    bool anchored {false};
+
+    std::vector<word_check> words;
+
+    compiled_swar(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        init();
+    }
+
+    compiled_swar(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        init();
+    }
+
+    // Higher is more selective: fixed bits first, then rarity.
+    int score(size_t i) const
+    {
+        return std::popcount(byte_mask[i]) * 64 - commonness(bytes[i]);
+    }
+
+    void init()
+    {
+        const size_t m = size();
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            if (byte_mask[i] == 0)
+                continue;
+
+            if (!anchored || score(i) >= score(anchor_a))
+                anchor_a = i;
+            anchored = true;
+        }
+
+        anchor_b = anchor_a;
+        for (size_t i = 0; anchored && i < m; ++i)
+        {
+            if (i != anchor_a && byte_mask[i] != 0 && (anchor_b == anchor_a || score(i) >= score(anchor_b)))
+                anchor_b = i;
+        }
+
+        if (m < 8)
+            return;
+
+        // Words that cover every non-wildcard byte. The last one slides back over bytes already covered.
+        for (size_t i = 0; i < m;)
+        {
+            if (byte_mask[i] == 0)
+            {
+                ++i;
+                continue;
+            }
+
+            const size_t offset = (i + 8 <= m) ? i : (m - 8);
+            byte value[8] {};
+            byte mask[8] {};
+            for (size_t k = 0; k < 8; ++k)
+            {
+                if (offset + k < i)
+                    continue;
+
+                value[k] = bytes[offset + k];
+                mask[k] = byte_mask[offset + k];
+            }
+
+            words.push_back({offset, load_u64(value), load_u64(mask)});
+            i = offset + 8;
+        }
+    }
+
+    bool verify(const byte* candidate) const
+    {
+        if (words.empty())
+            return matches(candidate);
+
+        for (const word_check& w : words)
+        {
+            if ((load_u64(candidate + w.offset) & w.mask) != w.value)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static void scan(const compiled_swar& compiled, const byte* data, size_t length, match_sink& results)
+{
+    const size_t m = compiled.size();
+    if (m == 0 || m > length)
+        return;
+
+    const size_t last = length - m;
+    size_t pos = 0;
+
+    if (compiled.anchored)
+    {
+        const size_t oa = compiled.anchor_a;
+        const size_t ob = compiled.anchor_b;
+        const uint64_t mask_a = ones * compiled.byte_mask[oa];
+        const uint64_t value_a = ones * compiled.bytes[oa];
+        const uint64_t mask_b = ones * compiled.byte_mask[ob];
+        const uint64_t value_b = ones * compiled.bytes[ob];
+
+        // Candidates pos .. pos + 7 all fit, so both loads stay inside the data.
+        for (; pos + 7 <= last; pos += 8)
+        {
+            const uint64_t a = (load_u64(data + pos + oa) & mask_a) ^ value_a;
+            const uint64_t b = (load_u64(data + pos + ob) & mask_b) ^ value_b;
+
+            for (uint64_t hits = zero_bytes(a) & zero_bytes(b); hits;)
+            {
+                const byte* candidate = data + pos + first_lane(hits);
+                if (compiled.verify(candidate) && !results.push(candidate))
+                    return;
+
+                hits = clear_first_lane(hits);
+            }
+        }
+    }
+
+    for (; pos <= last; ++pos)
+    {
+        if (compiled.verify(data + pos) && !results.push(data + pos))
+            return;
+    }
+}
+} // namespace swar_impl
+
+struct swar_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<swar_impl::compiled_swar>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<swar_impl::compiled_swar>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        swar_impl::scan(static_cast<const swar_impl::compiled_swar&>(pattern), data, length, results);
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "SWAR (64-bit)";
+    }
+};
+
+REGISTER_PATTERN(swar_pattern_scanner);
@@ -37,7 +37,7 @@ struct ParseResult
 
     inline bool TrimmedIsFirstTrullySolid() const
     {
-        return getTrimmedCompareMask()[0] != 0;
+        return getTrimmedCompareMask()[0] == 0xFF;
     }
 };
 
@@ -78,6 +78,32 @@ static bool Parse(const byte* pattern, const char* mask, ParseResult& result)
     return result.mParseSuccess = true;
 }
 
+static bool Parse(const byte* pattern, const byte* byteMasks, size_t patternLen, ParseResult& result)
+{
+    result = ParseResult{};
+
+    if (pattern == nullptr || byteMasks == nullptr)
+        return false;
+
+    result.mPattern.resize(patternLen);
+    result.mCompareMask.assign(byteMasks, byteMasks + patternLen);
+
+    bool firstSolidFound = false;
+    for (size_t i = 0; i < patternLen; ++i)
+    {
+        result.mPattern[i] = pattern[i] & byteMasks[i];
+
+        // Only full wildcards are trimmed; a partial mask still has to be compared.
+        if (!firstSolidFound && byteMasks[i] != 0x00)
+        {
+            result.mTrimmDisp = i;
+            firstSolidFound = true;
+        }
+    }
+
+    return result.mParseSuccess = true;
+}
+
 static const byte* SearchFirst(const byte* start, const byte* end, byte value)
 {
     for (const byte* i = start; i != end; ++i)
@@ -102,16 +128,14 @@ static bool Compare(const byte* chunk1, const byte* chunk2, size_t len, const by
     return true;
 }
 
-static bool LightScan(const byte* start, const byte* end, std::vector<const byte*>& results, const ParseResult& parsed)
+static void LightScan(const byte* start, const byte* end, match_sink& results, const ParseResult& parsed)
 {
-    results.clear();
-
     if (start >= end)
-        return false;
+        return;
 
     const size_t patternSize = parsed.getTrimmedSize();
     if (patternSize == 0)
-        return false;
+        return;
 
     const byte* found = start;
     bool firstStep = true;
@@ -138,34 +162,56 @@ static bool LightScan(const byte* start, const byte* end, std::vector<const byte
 
     for (next(); found && (found + patternSize - 1) < end; next())
     {
+        // Leading wildcards were trimmed, so the full match must still start inside the range.
+        if (found < start + parsed.mTrimmDisp)
+            continue;
+
         if (!Compare(found, parsed.getTrimmedPattern(), patternSize, parsed.getTrimmedCompareMask()))
             continue;
 
-        results.push_back(found - parsed.mTrimmDisp);
+        if (!results.push(found - parsed.mTrimmDisp))
+            return;
     }
-
-    return !results.empty();
 }
 
-static std::vector<const byte*> FindAll(const byte* data, size_t length, const byte* pattern, const char* mask)
+struct CompiledPattern : compiled_pattern
 {
     ParseResult parsed;
-    std::vector<const byte*> results;
 
-    if (!Parse(pattern, mask, parsed) || !parsed)
-        return results;
+    CompiledPattern(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+    {
+        Parse(pattern, mask, parsed);
+    }
 
-    LightScan(data, data + length, results, parsed);
-    return results;
-}
+    CompiledPattern(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+    {
+        Parse(pattern, byte_masks, length, parsed);
+    }
+};
 } // namespace tbs_impl
 
 struct tbs_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<tbs_impl::CompiledPattern>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
     {
-        return tbs_impl::FindAll(data, length, pattern, mask);
+        return std::make_unique<tbs_impl::CompiledPattern>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        const tbs_impl::ParseResult& parsed = static_cast<const tbs_impl::CompiledPattern&>(pattern).parsed;
+
+        if (parsed)
+            tbs_impl::LightScan(data, data + length, results, parsed);
     }
 
     virtual const char* GetName() const override
@@ -0,0 +1,347 @@
+// Teddy-style multi-pattern prefilter, after the literal matcher in Hyperscan.
+//
+// Each pattern gets a window of up to four bytes and one of 16 buckets (two banks of eight). For every window byte, two
+// pshufb lookups per bank (low and high nibble) give the set of buckets whose pattern accepts that byte there. ANDing
+// the lookups of the shifted loads leaves a bucket bit only where a member's whole window matches, and those candidates
+// are verified against the member's byte masks. Up to 64 patterns share one pass over the data; sets of up to eight
+// only use the first bank.
+
+#include "byte_stats.h"
+#include "pattern_entry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
+
+namespace teddy_impl
+{
+static constexpr size_t max_window = 4;
+static constexpr size_t bank_count = 2;
+static constexpr size_t bucket_count = 8 * bank_count;
+static constexpr size_t max_members = 64;
+
+static inline size_t bit_count(byte v)
+{
+    size_t count = 0;
+    for (; v != 0; v &= static_cast<byte>(v - 1))
+        ++count;
+    return count;
+}
+
+struct member
+{
+    compiled_pattern pattern;
+    size_t window_offset {0};
+    size_t index {0}; // Output slot of this pattern.
+};
+
+struct table
+{
+    size_t window {0};
+    size_t banks {1};
+
+    // Bucket bits per nibble value, per bank and window byte. Both 128-bit lanes hold the same 16 entries for vpshufb.
+    alignas(32) byte lo[bank_count][max_window][32] {};
+    alignas(32) byte hi[bank_count][max_window][32] {};
+
+    std::vector<member> buckets[bucket_count];
+
+    // members must be non-empty and at most max_members long. Without a sample every byte value is equally likely.
+    explicit table(std::vector<member> members, const byte_sample* sample = nullptr)
+    {
+        window = max_window;
+        for (const member& m : members)
+            window = (std::min)(window, m.pattern.size());
+
+        // Place each window where a random position is least likely to match it.
+        std::vector<double> shares;
+        for (member& m : members)
+        {
+            const byte* values = m.pattern.pattern();
+            const byte* masks = m.pattern.byte_masks();
+
+            shares.resize(m.pattern.size());
+            for (size_t i = 0; i < shares.size(); ++i)
+            {
+                shares[i] = sample ? sample->masked_log_share(values[i], masks[i])
+                                   : -0.6931471805599453 * double(bit_count(masks[i]));
+            }
+
+            double best = 1.0;
+            for (size_t offset = 0; offset + window <= m.pattern.size(); ++offset)
+            {
+                double score = 0.0;
+                for (size_t j = 0; j < window; ++j)
+                    score += shares[offset + j];
+
+                if (score < best)
+                {
+                    best = score;
+                    m.window_offset = offset;
+                }
+            }
+        }
+
+        // Members with similar windows share a bucket, so a bucket's nibble sets stay small.
+        std::sort(members.begin(), members.end(), [this](const member& lhs, const member& rhs) {
+            const byte* l = lhs.pattern.pattern() + lhs.window_offset;
+            const byte* r = rhs.pattern.pattern() + rhs.window_offset;
+            return std::lexicographical_compare(l, l + window, r, r + window);
+        });
+
+        const size_t count = members.size();
+        const size_t used_buckets = (count <= 8) ? 8 : bucket_count;
+        banks = used_buckets / 8;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            member& m = members[i];
+            const size_t bucket = (count <= used_buckets) ? i : (i * used_buckets / count);
+            const size_t bank = bucket / 8;
+            const byte bit = static_cast<byte>(1u << (bucket % 8));
+
+            for (size_t j = 0; j < window; ++j)
+            {
+                const byte value = m.pattern.pattern()[m.window_offset + j];
+                const byte mask = m.pattern.byte_masks()[m.window_offset + j];
+
+                for (unsigned n = 0; n < 16; ++n)
+                {
+                    if (((n ^ value) & mask & 0x0Fu) == 0)
+                        lo[bank][j][n] |= bit;
+                    if (((n ^ (value >> 4)) & (mask >> 4)) == 0)
+                        hi[bank][j][n] |= bit;
+                }
+            }
+
+            buckets[bucket].push_back(std::move(m));
+        }
+
+        for (size_t bank = 0; bank < bank_count; ++bank)
+        {
+            for (size_t j = 0; j < window; ++j)
+            {
+                std::memcpy(lo[bank][j] + 16, lo[bank][j], 16);
+                std::memcpy(hi[bank][j] + 16, hi[bank][j], 16);
+            }
+        }
+    }
+
+    // Bucket bits of the window at window_start, bank 1 in the high byte.
+    uint32_t lookup(const byte* window_start) const
+    {
+        uint32_t bits = 0;
+        for (size_t bank = 0; bank < banks; ++bank)
+        {
+            uint32_t bank_bits = 0xFF;
+            for (size_t j = 0; j < window; ++j)
+                bank_bits &= lo[bank][j][window_start[j] & 0x0F] & hi[bank][j][window_start[j] >> 4];
+            bits |= bank_bits << (bank * 8);
+        }
+        return bits;
+    }
+};
+
+// Verifies the members of every bucket in bits against the window that starts at pos.
+// Report(index, match) returns false to stop the scan.
+template <typename Report>
+MEM_STRONG_INLINE bool verify(
+    const table& t, const byte* data, const byte* end, const byte* pos, uint32_t bits, Report& report)
+{
+    while (bits != 0)
+    {
+        const unsigned bucket = first_set_bit(bits);
+        bits &= bits - 1;
+
+        for (const member& m : t.buckets[bucket])
+        {
+            if (static_cast<size_t>(pos - data) < m.window_offset)
+                continue;
+
+            const byte* candidate = pos - m.window_offset;
+            if (m.pattern.size() > static_cast<size_t>(end - candidate) || !m.pattern.matches(candidate))
+                continue;
+
+            if (!report(m.index, candidate))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+template <size_t Window>
+BENCH_TARGET_AVX2 MEM_STRONG_INLINE __m256i lookup_avx2(const table& t, size_t bank, const __m256i (&d)[Window])
+{
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i res = _mm256_set1_epi8(-1);
+
+    for (size_t j = 0; j < Window; ++j)
+    {
+        const __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.lo[bank][j]));
+        const __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.hi[bank][j]));
+        const __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(d[j], low4));
+        const __m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(d[j], 4), low4));
+        res = _mm256_and_si256(res, _mm256_and_si256(l, h));
+    }
+
+    return res;
+}
+
+template <size_t Window, size_t Banks, typename Report>
+BENCH_TARGET_AVX2 static void scan_avx2(const table& t, const byte* data, size_t length, Report& report)
+{
+    if (length < Window)
+        return;
+
+    const byte* const end = data + length;
+    const byte* const last = end - Window; // Last window start.
+    const byte* pos = data;
+
+    alignas(32) byte lanes[Banks][32];
+
+    for (; pos + 32 <= last + 1; pos += 32)
+    {
+        __m256i d[Window];
+        for (size_t j = 0; j < Window; ++j)
+            d[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + j));
+
+        __m256i res[Banks];
+        __m256i any = _mm256_setzero_si256();
+        for (size_t bank = 0; bank < Banks; ++bank)
+        {
+            res[bank] = lookup_avx2<Window>(t, bank, d);
+            any = _mm256_or_si256(any, res[bank]);
+        }
+
+        uint32_t hits = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(any, _mm256_setzero_si256())));
+        if (hits == 0)
+            continue;
+
+        for (size_t bank = 0; bank < Banks; ++bank)
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[bank]), res[bank]);
+
+        do
+        {
+            const unsigned lane = first_set_bit(hits);
+            hits &= hits - 1;
+
+            uint32_t bits = lanes[0][lane];
+            if constexpr (Banks > 1)
+                bits |= static_cast<uint32_t>(lanes[1][lane]) << 8;
+
+            if (!verify(t, data, end, pos + lane, bits, report))
+                return;
+        } while (hits != 0);
+    }
+
+    for (; pos <= last; ++pos)
+    {
+        const uint32_t bits = t.lookup(pos);
+        if (bits != 0 && !verify(t, data, end, pos, bits, report))
+            return;
+    }
+}
+
+template <size_t Banks, typename Report>
+static void scan_banks(const table& t, const byte* data, size_t length, Report& report)
+{
+    if (t.window == 4)
+        scan_avx2<4, Banks>(t, data, length, report);
+    else if (t.window == 3)
+        scan_avx2<3, Banks>(t, data, length, report);
+    else if (t.window == 2)
+        scan_avx2<2, Banks>(t, data, length, report);
+    else
+        scan_avx2<1, Banks>(t, data, length, report);
+}
+
+template <typename Report>
+static void scan(const table& t, const byte* data, size_t length, Report& report)
+{
+    if (t.banks == 1)
+        scan_banks<1>(t, data, length, report);
+    else
+        scan_banks<2>(t, data, length, report);
+}
+
+struct compiled_teddy : compiled_pattern
+{
+    table filter;
+
+    compiled_teddy(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , filter({member {*this, 0, 0}})
+    {}
+
+    compiled_teddy(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+        , filter({member {*this, 0, 0}})
+    {}
+};
+} // namespace teddy_impl
+
+struct teddy_pattern_scanner : pattern_scanner
+{
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<teddy_impl::compiled_teddy>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
+    {
+        return std::make_unique<teddy_impl::compiled_teddy>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        auto report = [&results](size_t, const byte* match) { return results.push(match); };
+
+        teddy_impl::scan(static_cast<const teddy_impl::compiled_teddy&>(pattern).filter, data, length, report);
+    }
+
+    // One pass per group of up to 64 patterns.
+    virtual std::vector<std::vector<const byte*>> ScanMany(const byte* const* patterns, const char* const* masks,
+        size_t count, const byte* data, size_t length) const override
+    {
+        std::vector<std::vector<const byte*>> results(count);
+        auto report = [&results](size_t index, const byte* match) {
+            results[index].push_back(match);
+            return true;
+        };
+
+        const byte_sample sample(data, length);
+
+        for (size_t base = 0; base < count; base += teddy_impl::max_members)
+        {
+            const size_t group = (std::min)(count - base, teddy_impl::max_members);
+
+            std::vector<teddy_impl::member> members;
+            members.reserve(group);
+            for (size_t i = base; i < base + group; ++i)
+                members.push_back({compiled_pattern(patterns[i], masks[i]), 0, i});
+
+            const teddy_impl::table filter(std::move(members), &sample);
+            teddy_impl::scan(filter, data, length, report);
+        }
+
+        return results;
+    }
+
+    virtual scanner_traits GetTraits() const override
+    {
+        return {.isa = CPU_AVX2 | CPU_BMI1, .multi_pattern = true};
+    }
+
+    virtual const char* GetName() const override
+    {
+        return "Teddy";
+    }
+};
+
+REGISTER_PATTERN(teddy_pattern_scanner);
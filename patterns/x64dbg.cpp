@@ -37,8 +37,21 @@ size_t patternfind(const unsigned char* data, size_t datasize, const std::vector
 
     if (anchor == searchpatternsize)
     {
-        // All bytes are wildcard: first valid hit is the start.
-        return 0;
+        // No fully-specified byte (all wildcards or nibble masks): test every start.
+        for (size_t pos = 0; pos <= last_start; ++pos)
+        {
+            size_t i = 0;
+            for (; i < searchpatternsize; ++i)
+            {
+                if (!patternmatchbyte(data[pos + i], pat[i]))
+                    break;
+            }
+
+            if (i == searchpatternsize)
+                return pos;
+        }
+
+        return static_cast<size_t>(-1);
     }
 
     const unsigned char anchor_value = pat[anchor].value;
@@ -89,12 +102,39 @@ static std::vector<PatternByte> to_pattern_bytes(const byte* pattern, const char
     return out;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+static std::vector<PatternByte> to_pattern_bytes(const byte* pattern, const byte* byte_masks, size_t length)
+{
+    std::vector<PatternByte> out(length);
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        out[i].value = pattern[i] & byte_masks[i];
+        out[i].mask = byte_masks[i];
+    }
+
+    return out;
+}
+
+struct CompiledPattern : compiled_pattern
+{
+    std::vector<PatternByte> pattern_bytes;
+
+    CompiledPattern(const byte* pattern, const char* mask)
+        : compiled_pattern(pattern, mask)
+        , pattern_bytes(to_pattern_bytes(pattern, mask))
+    {}
+
+    CompiledPattern(const byte* pattern, const byte* byte_masks, size_t length)
+        : compiled_pattern(pattern, byte_masks, length)
+        , pattern_bytes(to_pattern_bytes(pattern, byte_masks, length))
+    {}
+};
+
+static void find_all(const byte* data, size_t length, const CompiledPattern& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const std::vector<PatternByte> parsed = to_pattern_bytes(pattern, mask);
+    const std::vector<PatternByte>& parsed = compiled.pattern_bytes;
     if (parsed.empty())
-        return results;
+        return;
 
     size_t base = 0;
     while (base < length)
@@ -104,20 +144,38 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
             break;
 
         const size_t absolute = base + hit;
-        results.push_back(data + absolute);
+        if (!results.push(data + absolute))
+            return;
         base = absolute + 1;
     }
-
-    return results;
 }
 } // namespace x64dbg_impl
 
 struct x64dbg_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return std::make_unique<x64dbg_impl::CompiledPattern>(pattern, mask);
+    }
+
+    virtual std::unique_ptr<compiled_pattern> CompileMasked(
+        const byte* pattern, const byte* byte_masks, size_t length) const override
     {
-        return x64dbg_impl::find_all(data, length, pattern, mask);
+        return std::make_unique<x64dbg_impl::CompiledPattern>(pattern, byte_masks, length);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
+    {
+        x64dbg_impl::find_all(data, length, static_cast<const x64dbg_impl::CompiledPattern&>(pattern), results);
+    }
+
+    virtual const byte* ScanFirst(const compiled_pattern& pattern, const byte* data, size_t length) const override
+    {
+        const size_t hit = x64dbg_impl::patternfind(
+            data, length, static_cast<const x64dbg_impl::CompiledPattern&>(pattern).pattern_bytes);
+
+        return (hit != static_cast<size_t>(-1)) ? (data + hit) : nullptr;
     }
 
     virtual const char* GetName() const override
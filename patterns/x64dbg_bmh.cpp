@@ -44,24 +44,27 @@ static std::vector<PatternByte> to_pattern_bytes(const byte* pattern, const char
     return out;
 }
 
-struct CompiledPattern
+struct CompiledPattern : compiled_pattern
 {
-    std::vector<PatternByte> bytes;
+    std::vector<PatternByte> pattern_bytes;
     std::array<size_t, 256> skip {};
     size_t last = 0;
+
+    using compiled_pattern::compiled_pattern;
 };
 
-static CompiledPattern compile_pattern(const byte* pattern, const char* mask)
+static std::unique_ptr<CompiledPattern> compile_pattern(const byte* pattern, const char* mask)
 {
-    CompiledPattern compiled;
-    compiled.bytes = to_pattern_bytes(pattern, mask);
+    auto result = std::make_unique<CompiledPattern>(pattern, mask);
+    CompiledPattern& compiled = *result;
+    compiled.pattern_bytes = to_pattern_bytes(pattern, mask);
 
-    if (compiled.bytes.empty())
-        return compiled;
+    if (compiled.pattern_bytes.empty())
+        return result;
 
-    compiled.last = compiled.bytes.size() - 1;
+    compiled.last = compiled.pattern_bytes.size() - 1;
     size_t idx = compiled.last;
-    while (idx > 0 && compiled.bytes[idx].mask == 0xFF)
+    while (idx > 0 && compiled.pattern_bytes[idx].mask == 0xFF)
         --idx;
 
     size_t diff = compiled.last - idx;
@@ -71,21 +74,19 @@ static CompiledPattern compile_pattern(const byte* pattern, const char* mask)
     compiled.skip.fill(diff);
     for (size_t i = compiled.last - diff; i < compiled.last; ++i)
     {
-        if (compiled.bytes[i].mask == 0xFF)
-            compiled.skip[compiled.bytes[i].value] = compiled.last - i;
+        if (compiled.pattern_bytes[i].mask == 0xFF)
+            compiled.skip[compiled.pattern_bytes[i].value] = compiled.last - i;
     }
 
-    return compiled;
+    return result;
 }
 
-static std::vector<const byte*> find_all(const byte* data, size_t length, const byte* pattern, const char* mask)
+static void find_all(const byte* data, size_t length, const CompiledPattern& compiled, match_sink& results)
 {
-    std::vector<const byte*> results;
-    const CompiledPattern compiled = compile_pattern(pattern, mask);
-    const std::vector<PatternByte>& parsed = compiled.bytes;
+    const std::vector<PatternByte>& parsed = compiled.pattern_bytes;
     const size_t searchpatternsize = parsed.size();
     if (searchpatternsize == 0 || length < searchpatternsize)
-        return results;
+        return;
 
     const PatternByte* pat = parsed.data();
     const size_t last = compiled.last;
@@ -107,24 +108,28 @@ static std::vector<const byte*> find_all(const byte* data, size_t length, const
 
         if (matched)
         {
-            results.push_back(data + pos);
+            if (!results.push(data + pos))
+                return;
             ++pos; // preserve overlap behavior from repeated find-next-at+1 calls
             continue;
         }
 
         pos += compiled.skip[data[pos + last]];
     }
-
-    return results;
 }
 } // namespace x64dbg_bmh_impl
 
 struct x64dbg_bmh_pattern_scanner : pattern_scanner
 {
-    virtual std::vector<const byte*> Scan(
-        const byte* pattern, const char* mask, const byte* data, size_t length) const override
+    virtual std::unique_ptr<compiled_pattern> Compile(const byte* pattern, const char* mask) const override
+    {
+        return x64dbg_bmh_impl::compile_pattern(pattern, mask);
+    }
+
+    virtual void ScanInto(
+        const compiled_pattern& pattern, const byte* data, size_t length, match_sink& results) const override
     {
-        return x64dbg_bmh_impl::find_all(data, length, pattern, mask);
+        x64dbg_bmh_impl::find_all(data, length, static_cast<const x64dbg_bmh_impl::CompiledPattern&>(pattern), results);
     }
 
     virtual const char* GetName() const override
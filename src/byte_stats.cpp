@@ -0,0 +1,28 @@
+#include "byte_stats.h"
+
+#include <cmath>
+
+byte_sample::byte_sample(const byte* data, size_t length)
+{
+    for_each_block(data, length, [this](const byte* start) {
+        for (size_t j = 0; j < block; ++j)
+            ++counts[start[j]];
+
+        total += block;
+    });
+
+    for (size_t b = 0; b < 256; ++b)
+        log_share[b] = std::log((double(counts[b]) + 1.0) / (double(total) + 256.0));
+}
+
+double byte_sample::masked_log_share(byte value, byte mask) const
+{
+    uint64_t matching = 0;
+    for (unsigned b = 0; b < 256; ++b)
+    {
+        if (((b ^ value) & mask) == 0)
+            matching += counts[b];
+    }
+
+    return std::log((double(matching) + 1.0) / (double(total) + 256.0));
+}
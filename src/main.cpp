@@ -20,8 +20,10 @@
 #include <cassert>
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <iomanip>
@@ -55,8 +57,11 @@
 
 #include <fmt/format.h>
 
+#include "auto_scanner.h"
+#include "parallel_scanner.h"
 #include "pattern_entry.h"
 #include "rdtsc.h"
+#include "static_signature.h"
 
 static size_t LOG_LEVEL = 0;
 static bool PATHOLOGICAL_MODE = false;
@@ -108,6 +113,7 @@ enum class synthetic_corpus
     text,
     padding,
     entropy,
+    modrm,
 };
 
 static synthetic_corpus SYNTHETIC_CORPUS = synthetic_corpus::mixed;
@@ -128,6 +134,8 @@ static const char* synthetic_corpus_name(synthetic_corpus corpus)
         return "padding";
     case synthetic_corpus::entropy:
         return "entropy";
+    case synthetic_corpus::modrm:
+        return "modrm";
     }
 
     return "unknown";
@@ -171,6 +179,12 @@ static bool parse_synthetic_corpus(const char* value, synthetic_corpus& out)
         return true;
     }
 
+    if (std::strcmp(value, "modrm") == 0)
+    {
+        out = synthetic_corpus::modrm;
+        return true;
+    }
+
     return false;
 }
 
@@ -180,6 +194,15 @@ enum class bench_suite
     realistic,
     pathological,
     combined,
+    first_match,
+    batch,
+    batch_scaling,
+    chunked,
+    uniqueness,
+    regions,
+    catalog,
+    long_patterns,
+    dense_matches,
 };
 
 static bench_suite BENCH_SUITE = bench_suite::single;
@@ -196,6 +219,24 @@ static const char* bench_suite_name(bench_suite suite)
         return "pathological";
     case bench_suite::combined:
         return "combined";
+    case bench_suite::first_match:
+        return "first_match";
+    case bench_suite::batch:
+        return "batch";
+    case bench_suite::batch_scaling:
+        return "batch_scaling";
+    case bench_suite::chunked:
+        return "chunked";
+    case bench_suite::uniqueness:
+        return "uniqueness";
+    case bench_suite::regions:
+        return "regions";
+    case bench_suite::catalog:
+        return "catalog";
+    case bench_suite::long_patterns:
+        return "long_patterns";
+    case bench_suite::dense_matches:
+        return "dense_matches";
     }
 
     return "unknown";
@@ -227,6 +268,60 @@ static bool parse_bench_suite(const char* value, bench_suite& out)
         return true;
     }
 
+    if (std::strcmp(value, "first_match") == 0)
+    {
+        out = bench_suite::first_match;
+        return true;
+    }
+
+    if (std::strcmp(value, "batch") == 0)
+    {
+        out = bench_suite::batch;
+        return true;
+    }
+
+    if (std::strcmp(value, "batch_scaling") == 0)
+    {
+        out = bench_suite::batch_scaling;
+        return true;
+    }
+
+    if (std::strcmp(value, "chunked") == 0)
+    {
+        out = bench_suite::chunked;
+        return true;
+    }
+
+    if (std::strcmp(value, "uniqueness") == 0)
+    {
+        out = bench_suite::uniqueness;
+        return true;
+    }
+
+    if (std::strcmp(value, "regions") == 0)
+    {
+        out = bench_suite::regions;
+        return true;
+    }
+
+    if (std::strcmp(value, "catalog") == 0)
+    {
+        out = bench_suite::catalog;
+        return true;
+    }
+
+    if (std::strcmp(value, "long_patterns") == 0)
+    {
+        out = bench_suite::long_patterns;
+        return true;
+    }
+
+    if (std::strcmp(value, "dense_matches") == 0)
+    {
+        out = bench_suite::dense_matches;
+        return true;
+    }
+
     return false;
 }
 
@@ -241,6 +336,141 @@ static const std::array<const char*, 8> PATHOLOGICAL_CASES {{
     "boundary_alignment",
 }};
 
+// Cases of the dense_matches suite, where a large share of the offsets match.
+static const std::array<const char*, 3> DENSE_MATCH_CASES {{
+    "high_overlap_matches",
+    "padding_flood",
+    "zero_flood",
+}};
+
+// Set while the dense_matches suite runs: the oracle is a match_bitmap, and no set of offsets is built.
+static bool DENSE_MATCH_MODE = false;
+
+// Only matches at addresses that are a multiple of this are reported (--align). Generators plant hits on it.
+static size_t SCAN_ALIGNMENT = 1;
+
+// Threads of the parallel(<name>) adapters registered by --threads, or 1 when none are.
+static size_t PARALLEL_THREADS = 1;
+
+// Length range of synthetic realistic patterns (--pattern_length), or 0 for the built-in mix of 6 to 32 bytes.
+static size_t REALISTIC_LENGTH_MIN = 0;
+static size_t REALISTIC_LENGTH_MAX = 0;
+
+// Length range of the long_patterns suite when --pattern_length is not given.
+static constexpr size_t LONG_PATTERN_LENGTH_MIN = 64;
+static constexpr size_t LONG_PATTERN_LENGTH_MAX = 4096;
+
+// Set while the long_patterns suite runs: realistic patterns get sparse wildcards, like data blobs and tables.
+static bool LONG_PATTERN_MODE = false;
+
+// Number of patterns per test in the batch suite, or 0 when the suite is not running.
+static size_t BATCH_PATTERN_COUNT = 0;
+
+// Set sizes for the batch_scaling suite when --patterns is not given.
+static const std::array<size_t, 4> BATCH_SCALING_COUNTS {{10, 100, 1000, 10000}};
+
+// Scanners without scanner_traits::multi_pattern make one pass per pattern. batch_scaling skips them above this.
+static constexpr size_t BATCH_SINGLE_PASS_LIMIT = 1000;
+
+// Depths of the first true hit for the first_match suite. SIZE_MAX places it at the end of the region.
+static const std::array<size_t, 3> FIRST_MATCH_DEPTHS {{1024, 1024 * 1024, SIZE_MAX}};
+
+// Active first_match depth, or 0 when the suite is not running.
+static size_t FIRST_MATCH_DEPTH = 0;
+
+// Hit counts planted by the uniqueness suite. SIZE_MAX floods the region with a hit every UNIQUENESS_FLOOD_STRIDE bytes.
+struct uniqueness_case
+{
+    const char* name;
+    size_t hits;
+};
+
+static const std::array<uniqueness_case, 3> UNIQUENESS_CASES {{
+    {"none", 0},
+    {"unique", 1},
+    {"many", SIZE_MAX},
+}};
+
+static constexpr size_t UNIQUENESS_FLOOD_STRIDE = 64;
+
+// Active uniqueness case, or nullptr when the suite is not running.
+static const uniqueness_case* UNIQUENESS_CASE = nullptr;
+
+// Largest region of the regions suite, in pages, for each layout. Region sizes are log-uniform between one page and
+// this, and every region is followed by a PROT_NONE page.
+static const std::array<size_t, 3> REGION_MAX_PAGES_LIST {{256, 16, 1}};
+
+// Active region layout, or 0 when the suite is not running.
+static size_t REGION_MAX_PAGES = 0;
+
+// Chunk sizes for the chunked suite when --chunk is not given.
+// A signature compiled into the binary, with the same bytes and mask for the runtime scanners.
+struct catalog_signature
+{
+    const char* text;
+    std::vector<byte> pattern;
+    std::string masks;
+    void (*scan)(const byte* data, size_t length, match_sink& results);
+};
+
+template <static_signature_impl::literal Text>
+static catalog_signature make_catalog_signature()
+{
+    using sig = static_signature<Text>;
+
+    catalog_signature out {sig::text, {}, {}, &sig::scan};
+    for (size_t i = 0; i < sig::length; ++i)
+    {
+        // The oracle only knows 'x'/'?', so the catalog sticks to whole-byte wildcards.
+        assert(sig::layout.masks[i] == 0x00 || sig::layout.masks[i] == 0xFF);
+
+        out.pattern.push_back(sig::layout.bytes[i]);
+        out.masks.push_back((sig::layout.masks[i] == 0xFF) ? 'x' : '?');
+    }
+
+    return out;
+}
+
+// Fixed set of x64 signatures for the catalog suite, in the shapes that usually end up as literals in source.
+static const std::vector<catalog_signature>& static_catalog()
+{
+    static const std::vector<catalog_signature> catalog {
+        make_catalog_signature<"48 89 5C 24 ?? 48 89 74 24 ?? 57 48 83 EC ??">(),
+        make_catalog_signature<"48 8B 05 ?? ?? ?? ?? 48 85 C0 74 ??">(),
+        make_catalog_signature<"E8 ?? ?? ?? ?? 48 8B D8 48 85 C0 0F 84 ?? ?? ?? ??">(),
+        make_catalog_signature<"40 53 48 83 EC 20 48 8B D9 E8 ?? ?? ?? ??">(),
+        make_catalog_signature<"48 8D 0D ?? ?? ?? ?? E8 ?? ?? ?? ?? 84 C0">(),
+        make_catalog_signature<"FF 15 ?? ?? ?? ?? 8B F8 85 C0 78 ??">(),
+        make_catalog_signature<"0F B6 05 ?? ?? ?? ?? 3C 01 75 ??">(),
+        make_catalog_signature<"4C 8B DC 49 89 5B ?? 49 89 6B ?? 56 41 56 41 57">(),
+        make_catalog_signature<"F3 0F 10 05 ?? ?? ?? ?? F3 0F 59 C1">(),
+        make_catalog_signature<"83 F9 ?? 0F 87 ?? ?? ?? ?? 48 63 C1">(),
+        make_catalog_signature<"C7 44 24 ?? ?? ?? ?? ?? 48 8D 54 24">(),
+        make_catalog_signature<"66 0F 1F 44 00 00 48 8B ? 48 85">(),
+    };
+
+    return catalog;
+}
+
+// Set while the catalog suite runs: generate() plants static_catalog() instead of generated patterns.
+static bool CATALOG_MODE = false;
+
+static const std::array<size_t, 4> CHUNK_SIZES {{4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024}};
+
+static std::string byte_size_name(size_t size)
+{
+    if (size >= (1024 * 1024) && (size % (1024 * 1024)) == 0)
+        return fmt::format("{}MiB", size / (1024 * 1024));
+    if (size >= 1024 && (size % 1024) == 0)
+        return fmt::format("{}KiB", size / 1024);
+    return fmt::format("{}B", size);
+}
+
+static std::string first_match_depth_name(size_t depth)
+{
+    return (depth == SIZE_MAX) ? "end" : byte_size_name(depth);
+}
+
 static const char* resolve_pathological_case(const std::string& name, size_t iteration)
 {
     if (name == "all")
@@ -601,6 +831,7 @@ struct scanner_smoke_case
     std::vector<byte> data;
     std::vector<byte> pattern;
     std::string mask;
+    std::vector<byte> byte_masks; // Per-byte bit masks; when set, mask is ignored.
 };
 
 static void print_offsets(const char* label, const std::unordered_set<size_t>& values)
@@ -640,39 +871,264 @@ static std::unordered_set<size_t> to_offsets(
     return out;
 }
 
+// Oracle for batch runs. Buckets the patterns by their first exact byte so the whole batch costs one pass instead of
+// one FindPatternSimple per pattern. Candidates are verified exactly like FindPatternSimple does.
+static std::vector<std::unordered_set<size_t>> find_batch_offsets(
+    const byte* data, size_t length, const std::vector<std::vector<byte>>& patterns, const std::vector<std::string>& masks)
+{
+    std::vector<std::unordered_set<size_t>> out(patterns.size());
+    std::array<std::vector<size_t>, 256> buckets;
+    std::vector<size_t> anchors(patterns.size(), 0);
+
+    // Anchor every pattern on its rarest exact byte, so large sets do not pile into the buckets of common bytes.
+    std::array<size_t, 256> frequency {};
+    for (size_t pos = 0; pos < length; ++pos)
+        ++frequency[data[pos]];
+
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        size_t anchor = std::string::npos;
+        for (size_t j = 0; j < masks[i].size(); ++j)
+        {
+            if (masks[i][j] != 'x')
+                continue;
+
+            if (anchor == std::string::npos || frequency[patterns[i][j]] < frequency[patterns[i][anchor]])
+                anchor = j;
+        }
+
+        if (anchor == std::string::npos)
+        {
+            bool in_range = true;
+            out[i] = to_offsets(FindPatternSimple(data, length, patterns[i].data(), masks[i].c_str()), data, length, in_range);
+            continue;
+        }
+
+        anchors[i] = anchor;
+        buckets[patterns[i][anchor]].push_back(i);
+    }
+
+    for (size_t pos = 0; pos < length; ++pos)
+    {
+        for (size_t i : buckets[data[pos]])
+        {
+            const size_t pattern_length = masks[i].size();
+            if (pos < anchors[i] || (pos - anchors[i] + pattern_length) > length)
+                continue;
+
+            const byte* candidate = data + (pos - anchors[i]);
+            bool found = true;
+
+            for (size_t j = 0; j < pattern_length; ++j)
+            {
+                if ((candidate[j] != patterns[i][j]) && (masks[i][j] != '?'))
+                {
+                    found = false;
+                    break;
+                }
+            }
+
+            if (found)
+                out[i].emplace(pos - anchors[i]);
+        }
+    }
+
+    return out;
+}
+
+// A 3-thread adapter with 1-byte minimum slices around a fresh instance of scanner, or nullptr for scanners that
+// cannot be recreated by name (the parallel adapters themselves).
+static const pattern_scanner* smoke_parallel_scanner(const pattern_scanner& scanner)
+{
+    static std::unordered_map<const pattern_scanner*, std::unique_ptr<pattern_scanner>> parallel;
+
+    auto [iter, inserted] = parallel.try_emplace(&scanner);
+    if (inserted)
+    {
+        if (std::unique_ptr<pattern_scanner> inner = CreatePatternScanner(scanner.GetName()))
+            iter->second = parallel_scanner::wrap(std::move(inner), 3, 1);
+    }
+
+    return iter->second.get();
+}
+
 static bool run_scanner_case(
     smoke_stats& stats, mem::execution_handler& handler, const scanner_smoke_case& test_case)
 {
     bool ok = true;
 
-    const auto expected_raw = FindPatternSimple(
-        test_case.data.data(), test_case.data.size(), test_case.pattern.data(), test_case.mask.c_str());
+    const bool masked = !test_case.byte_masks.empty();
+    const auto expected_raw = masked
+        ? FindPatternSimple(test_case.data.data(), test_case.data.size(), test_case.pattern.data(),
+              test_case.byte_masks.data(), test_case.byte_masks.size())
+        : FindPatternSimple(
+              test_case.data.data(), test_case.data.size(), test_case.pattern.data(), test_case.mask.c_str());
 
     bool expected_in_range = true;
     const auto expected = to_offsets(expected_raw, test_case.data.data(), test_case.data.size(), expected_in_range);
     ok &= smoke_expect(stats, expected_in_range, test_case.name.c_str());
 
+    const byte* expected_first = expected_raw.empty() ? nullptr : expected_raw.front();
+
     for (const auto& scanner : PATTERN_SCANNERS)
     {
         bool scanner_ok = true;
         bool got_in_range = true;
         std::unordered_set<size_t> got;
+        const byte* got_first = nullptr;
         const char* exception_text = nullptr;
 
         try
         {
-            const auto results = handler.execute([&] {
-                return scanner->Scan(
-                    test_case.pattern.data(), test_case.mask.c_str(), test_case.data.data(), test_case.data.size());
-            });
+            const std::unique_ptr<compiled_pattern> compiled =
+                handler.execute([&] {
+                    return masked ? scanner->CompileMasked(
+                                        test_case.pattern.data(), test_case.byte_masks.data(), test_case.byte_masks.size())
+                                  : scanner->Compile(test_case.pattern.data(), test_case.mask.c_str());
+                });
+
+            const auto results = handler.execute(
+                [&] { return scanner->Scan(*compiled, test_case.data.data(), test_case.data.size()); });
+
+            got_first = handler.execute(
+                [&] { return scanner->ScanFirst(*compiled, test_case.data.data(), test_case.data.size()); });
 
             got = to_offsets(results, test_case.data.data(), test_case.data.size(), got_in_range);
 
+            if (got_first != expected_first)
+            {
+                scanner_ok = false;
+                exception_text = "ScanFirst mismatch";
+            }
+
+            // Bounded scans must stop at the limit, so 0 / 1 / many is decided without a full find-all.
+            const size_t count = handler.execute(
+                [&] { return scanner->CountMatches(*compiled, test_case.data.data(), test_case.data.size(), 2); });
+
+            std::vector<const byte*> bounded;
+            match_sink bounded_sink(bounded, 1);
+            handler.execute(
+                [&] { scanner->ScanVerified(*compiled, test_case.data.data(), test_case.data.size(), bounded_sink); });
+
+            const bool bounded_ok = expected_first ? (bounded.size() == 1 && bounded.front() == expected_first)
+                                                   : bounded.empty();
+
+            if (count != (std::min)(expected_raw.size(), size_t(2)) || !bounded_ok || bounded_sink.overflowed())
+            {
+                scanner_ok = false;
+                exception_text = "bounded scan mismatch";
+            }
+
+            // Streaming in small chunks must find the same matches, including the ones straddling chunk boundaries.
+            for (const size_t chunk_size : {1, 7, 64})
+            {
+                stream_scanner stream(*scanner, *compiled);
+                std::vector<size_t> streamed;
+
+                handler.execute([&] {
+                    for (size_t pos = 0; pos < test_case.data.size(); pos += chunk_size)
+                    {
+                        stream.Feed(test_case.data.data() + pos,
+                            (std::min)(chunk_size, test_case.data.size() - pos), streamed);
+                    }
+                });
+
+                const std::unordered_set<size_t> streamed_set(streamed.begin(), streamed.end());
+                if (streamed_set != expected || streamed.size() != expected.size() ||
+                    !std::is_sorted(streamed.begin(), streamed.end()))
+                {
+                    scanner_ok = false;
+                    exception_text = "stream_scanner mismatch";
+                }
+            }
+
+            // Aligned scans must keep exactly the expected matches whose address is a multiple of the alignment.
+            for (const size_t alignment : {4, 16})
+            {
+                std::vector<const byte*> expected_aligned;
+                for (const byte* hit : expected_raw)
+                {
+                    if ((reinterpret_cast<uintptr_t>(hit) & (alignment - 1)) == 0)
+                        expected_aligned.push_back(hit);
+                }
+
+                const auto aligned = handler.execute([&] {
+                    return scanner->ScanAligned(*compiled, test_case.data.data(), test_case.data.size(), alignment);
+                });
+
+                if (aligned != expected_aligned)
+                {
+                    scanner_ok = false;
+                    exception_text = "ScanAligned mismatch";
+                }
+            }
+
+            // Split into two regions: matches that straddle the split belong to neither.
+            {
+                const size_t split = test_case.data.size() / 2;
+                const scan_region regions[2] {
+                    {test_case.data.data(), split},
+                    {test_case.data.data() + split, test_case.data.size() - split},
+                };
+
+                std::vector<const byte*> expected_regions;
+                for (const byte* hit : expected_raw)
+                {
+                    const size_t offset = static_cast<size_t>(hit - test_case.data.data());
+                    if (offset >= split || (offset + test_case.mask.size()) <= split)
+                        expected_regions.push_back(hit);
+                }
+
+                const auto region_results = handler.execute([&] { return scanner->ScanRegions(*compiled, regions, 2); });
+
+                if (region_results != expected_regions)
+                {
+                    scanner_ok = false;
+                    exception_text = "ScanRegions mismatch";
+                }
+            }
+
+            // Bitmaps must set exactly the expected offsets, and their runs must cover them.
+            {
+                match_bitmap expected_bitmap;
+                expected_bitmap.reset(test_case.data.size());
+                for (const byte* hit : expected_raw)
+                    expected_bitmap.set(static_cast<size_t>(hit - test_case.data.data()));
+
+                match_bitmap bitmap;
+                handler.execute(
+                    [&] { scanner->ScanBitmap(*compiled, test_case.data.data(), test_case.data.size(), bitmap); });
+
+                size_t run_total = 0;
+                for (const match_run& run : bitmap.runs())
+                    run_total += run.length;
+
+                if (bitmap != expected_bitmap || run_total != expected_raw.size())
+                {
+                    scanner_ok = false;
+                    exception_text = "ScanBitmap mismatch";
+                }
+            }
+
+            // Tiny slices put matches across every slice boundary: each must be found exactly once.
+            if (const pattern_scanner* parallel = smoke_parallel_scanner(*scanner))
+            {
+                auto sliced = handler.execute(
+                    [&] { return parallel->Scan(*compiled, test_case.data.data(), test_case.data.size()); });
+                std::sort(sliced.begin(), sliced.end());
+
+                if (sliced != expected_raw)
+                {
+                    scanner_ok = false;
+                    exception_text = "parallel slicing mismatch";
+                }
+            }
+
             if (!got_in_range || got.size() != expected.size())
             {
                 scanner_ok = false;
             }
-            else
+            else if (scanner_ok)
             {
                 for (const size_t v : expected)
                 {
@@ -699,10 +1155,19 @@ static bool run_scanner_case(
                 fmt::print("Failure reason: {}\n", exception_text);
 
             fmt::print("Mask: {}\n", test_case.mask);
+            if (masked)
+                fmt::print("Byte masks: {}\n", mem::as_hex({test_case.byte_masks.data(), test_case.byte_masks.size()}));
             fmt::print("Pattern: {}\n", mem::as_hex({test_case.pattern.data(), test_case.pattern.size()}));
             fmt::print("Buffer: {}\n", mem::as_hex({test_case.data.data(), test_case.data.size()}));
             print_offsets("Expected", expected);
             print_offsets("Got", got);
+
+            if (got_first != expected_first)
+            {
+                fmt::print("First: expected {}, got {}\n",
+                    expected_first ? fmt::format("0x{:X}", expected_first - test_case.data.data()) : "<none>",
+                    got_first ? fmt::format("0x{:X}", got_first - test_case.data.data()) : "<none>");
+            }
         }
 
         ok &= smoke_expect(stats, scanner_ok, test_case.name.c_str());
@@ -722,6 +1187,19 @@ static scanner_smoke_case make_case(
     return out;
 }
 
+static scanner_smoke_case make_masked_case(const char* name, const std::initializer_list<byte>& data,
+    const std::initializer_list<byte>& pattern, const std::initializer_list<byte>& byte_masks)
+{
+    scanner_smoke_case out;
+    out.name = name;
+    out.data.assign(data.begin(), data.end());
+    out.pattern.assign(pattern.begin(), pattern.end());
+    out.byte_masks.assign(byte_masks.begin(), byte_masks.end());
+    for (byte m : out.byte_masks)
+        out.mask.push_back((m == 0xFF) ? 'x' : '?');
+    return out;
+}
+
 static bool run_scanner_smoke_tests(size_t fuzz_cases)
 {
     smoke_stats stats;
@@ -739,6 +1217,12 @@ static bool run_scanner_smoke_tests(size_t fuzz_cases)
         {0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x58, 0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x59},
         {0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x41, 0x42, 0x59}, "xxxxxxxxx"));
     cases.push_back(make_case("scanner_single_byte", {0x01, 0x02, 0x01, 0x01}, {0x01}, "x"));
+    cases.push_back(make_masked_case("scanner_modrm_reg_field",
+        {0x48, 0x89, 0xC8, 0x48, 0x89, 0xD8, 0x48, 0x89, 0xC1, 0x48, 0x8B, 0xC8}, {0x48, 0x89, 0xC0}, {0xFF, 0xFF, 0xC7}));
+    cases.push_back(make_masked_case("scanner_nibble_leading",
+        {0x12, 0x34, 0x1F, 0x34, 0x22, 0x34, 0x1A, 0x35}, {0x10, 0x34}, {0xF0, 0xFF}));
+    cases.push_back(make_masked_case("scanner_nibble_no_exact",
+        {0x41, 0x85, 0x4F, 0xBF, 0x50, 0x80, 0x48, 0x3F}, {0x40, 0x80}, {0xF0, 0xC0}));
     {
         auto make_sparse_pairless_case = [](const char* name, size_t length) {
             scanner_smoke_case out;
@@ -803,6 +1287,22 @@ static bool run_scanner_smoke_tests(size_t fuzz_cases)
 
         cases.push_back(sparse_false_negative);
     }
+    {
+        // Zero padding runs of every length up to 150, so runs of hits start and end on both sides of the 32 and 64
+        // bit boundaries of a match_bitmap.
+        scanner_smoke_case dense_runs;
+        dense_runs.name = "scanner_dense_padding_runs";
+        dense_runs.pattern = {0x00, 0x00, 0x00};
+        dense_runs.mask = "x?x";
+
+        for (size_t run = 1; dense_runs.data.size() < 3000; run = (run % 150) + 1)
+        {
+            dense_runs.data.insert(dense_runs.data.end(), run, static_cast<byte>(0x00));
+            dense_runs.data.push_back(0x90);
+        }
+
+        cases.push_back(dense_runs);
+    }
 
     for (const auto& test_case : cases)
     {
@@ -871,55 +1371,297 @@ static bool run_scanner_smoke_tests(size_t fuzz_cases)
         run_scanner_case(stats, handler, fuzz);
     }
 
-    fmt::print("Scanner smoke tests: {} passed, {} failed\n", stats.passed, stats.failed);
-    return stats.failed == 0;
-}
+    // Byte-mask fuzz: a mix of exact bytes, full wildcards and nibble/ModRM-style partial masks.
+    static const byte partial_masks[] = {0xF0, 0x0F, 0xC7, 0xC0, 0xF8, 0x38};
+    std::uniform_int_distribution<size_t> masked_len_dist(2, 40);
 
-struct scan_bench
-{
-private:
-    byte* raw_data_ {nullptr};
-    size_t raw_size_ {0};
+    for (size_t i = 0; i < fuzz_cases / 2; ++i)
+    {
+        scanner_smoke_case fuzz;
+        fuzz.name = fmt::format("scanner_masked_fuzz_{}", i);
 
-    byte* full_data_ {nullptr};
-    size_t full_size_ {0};
+        const size_t data_len = data_len_dist(rng);
+        fuzz.data.resize(data_len);
+        std::generate(fuzz.data.begin(), fuzz.data.end(), [&] { return static_cast<byte>(byte_dist(rng)); });
 
-    byte* data_ {nullptr};
-    size_t size_ {0};
+        const size_t pat_len = masked_len_dist(rng);
+        fuzz.pattern.resize(pat_len);
+        fuzz.byte_masks.resize(pat_len);
+        fuzz.mask.resize(pat_len);
 
-    uint32_t seed_ {0};
-    std::mt19937 rng_ {};
+        for (size_t j = 0; j < pat_len; ++j)
+        {
+            const uint32_t roll = byte_dist(rng) % 100u;
+            const byte m = (roll < 60u) ? 0xFF : (roll < 75u) ? 0x00 : partial_masks[rng() % sizeof(partial_masks)];
 
-    std::vector<byte> pattern_;
-    std::string masks_;
-    std::unordered_set<size_t> expected_;
-    size_t pathological_iteration_ {0};
+            fuzz.byte_masks[j] = m;
+            fuzz.pattern[j] = static_cast<byte>(byte_dist(rng) & m);
+            fuzz.mask[j] = (m == 0xFF) ? 'x' : '?';
+        }
 
-    byte random_byte()
-    {
-        return static_cast<byte>(rng_() & 0xFFu);
-    }
+        // Like the plain fuzz cases, never generate an all-wildcard pattern.
+        if (std::all_of(fuzz.byte_masks.begin(), fuzz.byte_masks.end(), [](byte m) { return m == 0x00; }))
+        {
+            const size_t force = rng() % pat_len;
+            fuzz.byte_masks[force] = 0xF0;
+            fuzz.pattern[force] = static_cast<byte>(byte_dist(rng) & 0xF0);
+        }
 
-    void fill_random_bytes(byte* out, size_t length)
-    {
-        for (size_t i = 0; i < length; ++i)
-            out[i] = random_byte();
-    }
+        std::uniform_int_distribution<size_t> offset_dist(0, data_len - pat_len);
+        const size_t inject_count = inject_count_dist(rng);
+        for (size_t k = 0; k < inject_count; ++k)
+        {
+            const size_t off = offset_dist(rng);
+            for (size_t j = 0; j < pat_len; ++j)
+                fuzz.data[off + j] = static_cast<byte>((fuzz.data[off + j] & ~fuzz.byte_masks[j]) | fuzz.pattern[j]);
+        }
 
-    static void write_u32_le(byte* out, uint32_t value)
-    {
-        out[0] = static_cast<byte>((value >> 0) & 0xFFu);
-        out[1] = static_cast<byte>((value >> 8) & 0xFFu);
-        out[2] = static_cast<byte>((value >> 16) & 0xFFu);
-        out[3] = static_cast<byte>((value >> 24) & 0xFFu);
+        run_scanner_case(stats, handler, fuzz);
     }
 
-    static void write_u64_le(byte* out, uint64_t value)
+    // Long patterns, past the 32- and 64-byte limits of window-based kernels. Own generator, so the cases above and
+    // below stay the same.
+    std::mt19937 long_rng(0x10C0FFEEu);
+    std::uniform_int_distribution<size_t> long_len_dist(33, 160);
+
+    for (size_t i = 0; i < fuzz_cases / 2; ++i)
     {
-        out[0] = static_cast<byte>((value >> 0) & 0xFFu);
-        out[1] = static_cast<byte>((value >> 8) & 0xFFu);
-        out[2] = static_cast<byte>((value >> 16) & 0xFFu);
-        out[3] = static_cast<byte>((value >> 24) & 0xFFu);
+        scanner_smoke_case fuzz;
+        fuzz.name = fmt::format("scanner_long_fuzz_{}", i);
+
+        const size_t pat_len = long_len_dist(long_rng);
+        fuzz.data.resize(pat_len * 8);
+        std::generate(fuzz.data.begin(), fuzz.data.end(), [&] { return static_cast<byte>(byte_dist(long_rng)); });
+
+        fuzz.pattern.resize(pat_len);
+        fuzz.mask.resize(pat_len);
+        for (size_t j = 0; j < pat_len; ++j)
+        {
+            const bool wildcard = (j != 0) && wildcard_dist(long_rng);
+            fuzz.pattern[j] = wildcard ? 0x00 : static_cast<byte>(byte_dist(long_rng));
+            fuzz.mask[j] = wildcard ? '?' : 'x';
+        }
+
+        std::uniform_int_distribution<size_t> offset_dist(0, fuzz.data.size() - pat_len);
+        const size_t inject_count = inject_count_dist(long_rng);
+        for (size_t k = 0; k < inject_count; ++k)
+        {
+            const size_t off = offset_dist(long_rng);
+            for (size_t j = 0; j < pat_len; ++j)
+            {
+                if (fuzz.mask[j] == 'x')
+                    fuzz.data[off + j] = fuzz.pattern[j];
+            }
+        }
+
+        run_scanner_case(stats, handler, fuzz);
+    }
+
+    // ScanMany: several patterns over one buffer, a mix of planted substrings and random (mostly absent) patterns.
+    for (size_t i = 0; i < 8; ++i)
+    {
+        const std::string name = fmt::format("scanner_batch_{}", i);
+
+        std::vector<byte> data(4096);
+        std::generate(data.begin(), data.end(), [&] { return static_cast<byte>(byte_dist(rng)); });
+
+        std::vector<std::vector<byte>> patterns(4 + (i * 8));
+        std::vector<std::string> masks(patterns.size());
+
+        for (size_t k = 0; k < patterns.size(); ++k)
+        {
+            const size_t pat_len = pat_len_dist(rng);
+            const size_t source = rng() % (data.size() - pat_len + 1);
+
+            patterns[k].assign(data.begin() + source, data.begin() + source + pat_len);
+            masks[k].assign(pat_len, 'x');
+
+            if (k & 1)
+            {
+                for (byte& v : patterns[k])
+                    v = static_cast<byte>(byte_dist(rng));
+            }
+
+            for (size_t j = 1; j < pat_len; ++j)
+            {
+                if (wildcard_dist(rng))
+                {
+                    masks[k][j] = '?';
+                    patterns[k][j] = 0x00;
+                }
+            }
+        }
+
+        const std::vector<std::unordered_set<size_t>> expected = find_batch_offsets(data.data(), data.size(), patterns, masks);
+
+        std::vector<const byte*> pattern_ptrs;
+        std::vector<const char*> mask_ptrs;
+        for (size_t k = 0; k < patterns.size(); ++k)
+        {
+            pattern_ptrs.push_back(patterns[k].data());
+            mask_ptrs.push_back(masks[k].c_str());
+        }
+
+        for (const auto& scanner : PATTERN_SCANNERS)
+        {
+            bool scanner_ok = true;
+
+            try
+            {
+                const auto results = handler.execute([&] {
+                    return scanner->ScanMany(
+                        pattern_ptrs.data(), mask_ptrs.data(), patterns.size(), data.data(), data.size());
+                });
+
+                scanner_ok = (results.size() == patterns.size());
+                for (size_t k = 0; scanner_ok && k < patterns.size(); ++k)
+                {
+                    bool in_range = true;
+                    scanner_ok = (to_offsets(results[k], data.data(), data.size(), in_range) == expected[k]) && in_range &&
+                        (results[k].size() == expected[k].size());
+
+                    if (!scanner_ok && LOG_LEVEL > 0)
+                        fmt::print("Scanner smoke failed: {} / {} (pattern {}, mask {})\n", scanner->GetName(), name, k,
+                            masks[k]);
+                }
+            }
+            catch (...)
+            {
+                scanner_ok = false;
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("Scanner smoke failed: {} / {} (exception)\n", scanner->GetName(), name);
+            }
+
+            smoke_expect(stats, scanner_ok, name.c_str());
+        }
+    }
+
+    // static_signature: every catalog signature, plus nibble and short patterns, over data with planted copies.
+    {
+        const std::vector<catalog_signature>& catalog = static_catalog();
+
+        std::vector<byte> data(4096);
+        std::generate(data.begin(), data.end(), [&] { return static_cast<byte>(byte_dist(rng)); });
+
+        std::vector<std::vector<byte>> patterns;
+        std::vector<std::string> masks;
+        for (const catalog_signature& sig : catalog)
+        {
+            // One copy at each end and one at a random offset, so both the first and the last candidate are checked.
+            const size_t offsets[] = {0, data.size() - sig.pattern.size(), rng() % (data.size() - sig.pattern.size())};
+            for (size_t offset : offsets)
+            {
+                for (size_t j = 0; j < sig.pattern.size(); ++j)
+                {
+                    if (sig.masks[j] == 'x')
+                        data[offset + j] = sig.pattern[j];
+                }
+            }
+
+            patterns.push_back(sig.pattern);
+            masks.push_back(sig.masks);
+        }
+
+        const std::vector<std::unordered_set<size_t>> expected = find_batch_offsets(data.data(), data.size(), patterns, masks);
+
+        for (size_t k = 0; k < catalog.size(); ++k)
+        {
+            std::vector<const byte*> results;
+            match_sink sink(results);
+            catalog[k].scan(data.data(), data.size(), sink);
+
+            bool in_range = true;
+            const bool ok = (to_offsets(results, data.data(), data.size(), in_range) == expected[k]) && in_range &&
+                (results.size() == expected[k].size());
+
+            if (!ok && LOG_LEVEL > 0)
+                fmt::print("Scanner smoke failed: static_signature / {}\n", catalog[k].text);
+
+            smoke_expect(stats, ok, "static_signature_catalog");
+        }
+
+        using nibble_sig = static_signature<"4? 8B ?0 ?? C3">;
+        static_assert(nibble_sig::length == 5 && nibble_sig::layout.masks[0] == 0xF0 && nibble_sig::layout.masks[2] == 0x0F);
+
+        const byte nibble_data[] = {0x48, 0x8B, 0x10, 0x99, 0xC3, 0x4F, 0x8B, 0x31, 0x00, 0xC3, 0x41, 0x8B, 0xF0, 0x00, 0xC3};
+        std::vector<const byte*> nibble_results;
+        match_sink nibble_sink(nibble_results);
+        nibble_sig::scan(nibble_data, sizeof(nibble_data), nibble_sink);
+        smoke_expect(stats,
+            nibble_results.size() == 2 && nibble_results[0] == nibble_data && nibble_results[1] == nibble_data + 10,
+            "static_signature_nibble");
+
+        const byte short_data[] = {0x90, 0xC3, 0x90, 0x90, 0xC3};
+        smoke_expect(stats, static_signature<"90 C3">::find_first(short_data, sizeof(short_data)) == short_data,
+            "static_signature_short");
+        smoke_expect(stats, static_signature<"90 ? 90">::find_first(short_data, 2) == nullptr,
+            "static_signature_too_long");
+    }
+
+    fmt::print("Scanner smoke tests: {} passed, {} failed\n", stats.passed, stats.failed);
+    return stats.failed == 0;
+}
+
+struct scan_bench
+{
+private:
+    byte* raw_data_ {nullptr};
+    size_t raw_size_ {0};
+
+    byte* full_data_ {nullptr};
+    size_t full_size_ {0};
+
+    byte* data_ {nullptr};
+    size_t size_ {0};
+
+    uint32_t seed_ {0};
+    std::mt19937 rng_ {};
+
+    std::vector<byte> pattern_;
+    std::string masks_;
+    std::vector<byte> byte_masks_; // Per-byte bit masks, or empty for a plain 'x'/'?' pattern.
+    std::unordered_set<size_t> expected_;
+    match_bitmap expected_bitmap_; // Oracle of the dense_matches suite, which leaves expected_ empty.
+    size_t pathological_iteration_ {0};
+
+    std::vector<std::vector<byte>> batch_patterns_;
+    std::vector<std::string> batch_masks_;
+    std::vector<std::unordered_set<size_t>> batch_expected_;
+
+    // Scatter-list copy of the region for the regions suite: regions_ tile [0, full_size_) of full_data_ in order,
+    // each in its own slice of region_raw_ behind an inaccessible page.
+    byte* region_raw_ {nullptr};
+    size_t region_raw_size_ {0};
+    std::vector<scan_region> regions_;
+    std::vector<size_t> region_offsets_;
+    std::unordered_set<size_t> region_expected_;
+
+    byte random_byte()
+    {
+        return static_cast<byte>(rng_() & 0xFFu);
+    }
+
+    void fill_random_bytes(byte* out, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+            out[i] = random_byte();
+    }
+
+    static void write_u32_le(byte* out, uint32_t value)
+    {
+        out[0] = static_cast<byte>((value >> 0) & 0xFFu);
+        out[1] = static_cast<byte>((value >> 8) & 0xFFu);
+        out[2] = static_cast<byte>((value >> 16) & 0xFFu);
+        out[3] = static_cast<byte>((value >> 24) & 0xFFu);
+    }
+
+    static void write_u64_le(byte* out, uint64_t value)
+    {
+        out[0] = static_cast<byte>((value >> 0) & 0xFFu);
+        out[1] = static_cast<byte>((value >> 8) & 0xFFu);
+        out[2] = static_cast<byte>((value >> 16) & 0xFFu);
+        out[3] = static_cast<byte>((value >> 24) & 0xFFu);
         out[4] = static_cast<byte>((value >> 32) & 0xFFu);
         out[5] = static_cast<byte>((value >> 40) & 0xFFu);
         out[6] = static_cast<byte>((value >> 48) & 0xFFu);
@@ -974,6 +1716,47 @@ private:
         }
     }
 
+    // Register-to-register and [reg+disp8] moves/arithmetic with REX prefixes, where only the ModRM register
+    // fields vary between otherwise identical instructions.
+    void fill_block_modrm_like(byte* out, size_t length)
+    {
+        static const byte rex_prefixes[] = {0x48, 0x49, 0x4C, 0x4D};
+        static const byte modrm_ops[] = {0x89, 0x8B, 0x8D, 0x33, 0x3B, 0x85, 0x01, 0x29};
+
+        size_t pos = 0;
+        while (pos < length)
+        {
+            const uint32_t roll = rng_() % 100u;
+            if (roll < 80 && (pos + 4) <= length)
+            {
+                out[pos++] = rex_prefixes[rng_() % (sizeof(rex_prefixes) / sizeof(rex_prefixes[0]))];
+                out[pos++] = modrm_ops[rng_() % (sizeof(modrm_ops) / sizeof(modrm_ops[0]))];
+
+                const byte modrm = static_cast<byte>(rng_() & 0xFFu);
+                if ((modrm >> 6) == 1u)
+                {
+                    out[pos++] = static_cast<byte>(modrm & 0x7Fu); // mod=01 reg, [r/m + disp8]
+                    out[pos++] = static_cast<byte>(rng_() & 0xF8u);
+                }
+                else
+                {
+                    out[pos++] = static_cast<byte>(modrm | 0xC0u); // mod=11 reg, reg
+                }
+            }
+            else if (roll < 90 && (pos + 5) <= length)
+            {
+                out[pos++] = 0xE8; // call rel32
+                write_u32_le(out + pos, rng_());
+                pos += 4;
+            }
+            else
+            {
+                static const byte single_ops[] = {0x55, 0x53, 0x5B, 0x5D, 0x90, 0xC3, 0xCC};
+                out[pos++] = single_ops[rng_() % (sizeof(single_ops) / sizeof(single_ops[0]))];
+            }
+        }
+    }
+
     void fill_block_structured(byte* out, size_t length)
     {
         size_t pos = 0;
@@ -1058,6 +1841,7 @@ private:
         size_t w_text = 13;
         size_t w_padding = 12;
         size_t w_entropy = 9;
+        size_t w_modrm = 0;
 
         switch (SYNTHETIC_CORPUS)
         {
@@ -1098,6 +1882,14 @@ private:
             w_padding = 5;
             w_entropy = 70;
             break;
+        case synthetic_corpus::modrm:
+            w_code = 15;
+            w_structured = 10;
+            w_text = 5;
+            w_padding = 5;
+            w_entropy = 5;
+            w_modrm = 60;
+            break;
         }
 
         const size_t t_code = w_code;
@@ -1105,6 +1897,7 @@ private:
         const size_t t_text = t_structured + w_text;
         const size_t t_padding = t_text + w_padding;
         const size_t t_entropy = t_padding + w_entropy;
+        const size_t t_modrm = t_entropy + w_modrm;
 
         for (size_t base = 0; base < length; base += block_size)
         {
@@ -1122,6 +1915,8 @@ private:
                 fill_block_padding_like(block, span);
             else if (roll < t_entropy)
                 fill_random_bytes(block, span); // high-entropy chunk
+            else if (roll < t_modrm)
+                fill_block_modrm_like(block, span);
             else
                 fill_random_bytes(block, span);
         }
@@ -1145,6 +1940,9 @@ private:
 
     size_t pick_realistic_pattern_length()
     {
+        if (REALISTIC_LENGTH_MIN != 0)
+            return REALISTIC_LENGTH_MIN + (rng_() % (REALISTIC_LENGTH_MAX - REALISTIC_LENGTH_MIN + 1));
+
         const uint32_t roll = rng_() % 100u;
         if (roll < 55u)
             return 6 + (rng_() % 7u); // 6..12
@@ -1156,6 +1954,9 @@ private:
     double pick_realistic_wildcard_rate()
     {
         const uint32_t roll = rng_() % 100u;
+        if (LONG_PATTERN_MODE)
+            return (roll < 50u) ? 0.01 : (roll < 85u) ? 0.03 : 0.06;
+
         if (roll < 55u)
             return 0.08;
         if (roll < 85u)
@@ -1182,7 +1983,7 @@ private:
         return best;
     }
 
-    void generate_random_case()
+    void generate_random_pattern()
     {
         std::uniform_int_distribution<uint32_t> byte_dist(0, 0xFF);
         std::uniform_int_distribution<size_t> length_dist(5, 32);
@@ -1211,107 +2012,321 @@ private:
                 }
             }
         } while (all_masks);
+    }
 
-        std::uniform_int_distribution<size_t> count_dist(2, 10);
-        const size_t result_count = count_dist(rng_);
-        std::uniform_int_distribution<size_t> range_dist(0, size() - pattern_.size());
-
-        for (size_t i = 0; i < result_count; ++i)
+    void plant_match(size_t offset)
+    {
+        if (!byte_masks_.empty())
         {
-            const size_t offset = range_dist(rng_);
+            // Only the masked bits are written, so partial bytes keep whatever the data had in their free bits.
             for (size_t j = 0; j < pattern_.size(); ++j)
-            {
-                if (masks_[j] != '?')
-                    data_[offset + j] = pattern_[j];
-            }
+                data_[offset + j] = static_cast<byte>((data_[offset + j] & ~byte_masks_[j]) | pattern_[j]);
+            return;
+        }
+
+        for (size_t j = 0; j < pattern_.size(); ++j)
+        {
+            if (masks_[j] != '?')
+                data_[offset + j] = pattern_[j];
         }
     }
 
-    void generate_synthetic_realistic_case()
+    // Moves a hit offset onto the nearest SCAN_ALIGNMENT boundary that still fits, rounding down when possible.
+    size_t align_hit_offset(size_t offset) const
     {
-        size_t pattern_length = pick_realistic_pattern_length();
-        if (pattern_length > size_)
-            pattern_length = size_;
+        const size_t misalign = reinterpret_cast<uintptr_t>(data_ + offset) & (SCAN_ALIGNMENT - 1);
+        if (misalign == 0)
+            return offset;
 
-        pattern_.resize(pattern_length);
-        masks_.resize(pattern_length);
+        return (offset >= misalign) ? (offset - misalign) : (offset + (SCAN_ALIGNMENT - misalign));
+    }
 
-        const size_t source_offset = rng_() % (size_ - pattern_length + 1);
-        std::memcpy(pattern_.data(), data_ + source_offset, pattern_length);
+    // Oracle over the first length bytes of the region, honouring byte masks and SCAN_ALIGNMENT.
+    std::vector<const byte*> find_expected(size_t length) const
+    {
+        std::vector<const byte*> results;
+        match_sink sink(results);
+        sink.align(SCAN_ALIGNMENT);
 
-        std::bernoulli_distribution wildcard_dist(pick_realistic_wildcard_rate());
-        bool any_exact = false;
-        std::vector<size_t> exact_positions;
-        exact_positions.reserve(pattern_length);
+        if (!byte_masks_.empty())
+            FindPatternSimple(data_, length, pattern(), byte_masks_.data(), pattern_.size(), sink);
+        else
+            FindPatternSimple(data_, length, pattern(), masks(), sink);
+
+        return results;
+    }
+
+    // find_expected into a bitmap over the whole region, for the dense_matches suite.
+    void find_expected_bitmap()
+    {
+        expected_bitmap_.reset(size());
+        match_sink sink(expected_bitmap_, data_);
+
+        if (!byte_masks_.empty())
+            FindPatternSimple(data_, size(), pattern(), byte_masks_.data(), pattern_.size(), sink);
+        else
+            FindPatternSimple(data_, size(), pattern(), masks(), sink);
+    }
+
+    // Narrows exact bytes of a pattern taken from ModRM-like code to the bits that identify the instruction:
+    // REX prefixes keep their high nibble, and a ModRM byte after a known opcode loses its reg field (0xC7) or
+    // both register fields (0xC0). At least two bytes stay exact so there is something to anchor on.
+    void apply_modrm_masks(std::vector<size_t>& exact_positions)
+    {
+        static const byte modrm_ops[] = {0x89, 0x8B, 0x8D, 0x33, 0x3B, 0x85, 0x01, 0x29};
+
+        const size_t pattern_length = pattern_.size();
+        std::vector<byte> masks(pattern_length);
         for (size_t i = 0; i < pattern_length; ++i)
-        {
-            if (wildcard_dist(rng_))
-            {
-                masks_[i] = '?';
-                pattern_[i] = 0x00;
-            }
-            else
-            {
-                masks_[i] = 'x';
-                any_exact = true;
-                exact_positions.push_back(i);
-            }
-        }
+            masks[i] = (masks_[i] == 'x') ? 0xFF : 0x00;
 
-        if (!any_exact)
-        {
-            const size_t force = rng_() % pattern_length;
-            masks_[force] = 'x';
-            pattern_[force] = data_[source_offset + force];
-            exact_positions.push_back(force);
-        }
+        size_t exact_left = exact_positions.size();
+        bool any_partial = false;
 
-        const size_t min_exact = (std::min)(static_cast<size_t>(4), pattern_length);
-        while (exact_positions.size() < min_exact)
+        for (size_t i = 0; i < pattern_length && exact_left > 2; ++i)
         {
-            const size_t pos = rng_() % pattern_length;
-            if (masks_[pos] == 'x')
+            if (masks[i] != 0xFF)
                 continue;
-            masks_[pos] = 'x';
-            pattern_[pos] = data_[source_offset + pos];
-            exact_positions.push_back(pos);
-        }
 
-        std::array<bool, 256> seen {};
-        size_t distinct_exact = 0;
-        for (size_t pos : exact_positions)
-        {
-            const byte v = pattern_[pos];
-            if (!seen[v])
-            {
-                seen[v] = true;
-                ++distinct_exact;
-            }
-        }
-        if (distinct_exact <= 1 && !exact_positions.empty())
-        {
-            const size_t pivot = exact_positions[rng_() % exact_positions.size()];
-            pattern_[pivot] = pick_rarest_data_byte();
+            const byte v = pattern_[i];
+            byte narrowed = 0xFF;
+
+            if ((v & 0xF0u) == 0x40u && (i + 1) < pattern_length && masks[i + 1] == 0xFF)
+                narrowed = 0xF0;
+            else if (i > 0 && masks[i - 1] == 0xFF &&
+                std::find(std::begin(modrm_ops), std::end(modrm_ops), pattern_[i - 1]) != std::end(modrm_ops))
+                narrowed = (rng_() & 1u) ? 0xC7 : 0xC0;
+
+            if (narrowed == 0xFF)
+                continue;
+
+            masks[i] = narrowed;
+            --exact_left;
+            any_partial = true;
         }
 
-        // Ensure at least one guaranteed true match in-buffer.
-        for (size_t j = 0; j < pattern_length; ++j)
+        if (!any_partial)
+            return;
+
+        exact_positions.clear();
+        for (size_t i = 0; i < pattern_length; ++i)
         {
-            if (masks_[j] == 'x')
-                data_[source_offset + j] = pattern_[j];
+            pattern_[i] &= masks[i];
+            if (masks[i] == 0xFF)
+                exact_positions.push_back(i);
+            else
+                masks_[i] = '?';
         }
 
-        // Keep real hit density low-to-moderate.
-        const size_t extra_hit_count = rng_() % 3u; // 0..2 additional hits
-        for (size_t i = 0; i < extra_hit_count; ++i)
+        byte_masks_ = std::move(masks);
+    }
+
+    void generate_random_case()
+    {
+        generate_random_pattern();
+
+        std::uniform_int_distribution<size_t> count_dist(2, 10);
+        const size_t result_count = count_dist(rng_);
+        std::uniform_int_distribution<size_t> range_dist(0, size() - pattern_.size());
+
+        for (size_t i = 0; i < result_count; ++i)
+            plant_match(align_hit_offset(range_dist(rng_)));
+    }
+
+    // Generates BATCH_PATTERN_COUNT independent single-pattern cases over the same region.
+    // Expected offsets are computed after all of them are planted, since later hits can match earlier patterns.
+    void generate_batch_case()
+    {
+        batch_patterns_.resize(BATCH_PATTERN_COUNT);
+        batch_masks_.resize(BATCH_PATTERN_COUNT);
+
+        for (size_t i = 0; i < BATCH_PATTERN_COUNT; ++i)
         {
-            const size_t off = rng_() % (size_ - pattern_length + 1);
-            for (size_t j = 0; j < pattern_length; ++j)
+            if (DATA_MODE == data_mode::synthetic_realistic)
+                generate_synthetic_realistic_case();
+            else
+                generate_random_case();
+
+            // ScanMany only takes 'x'/'?' masks, so any byte masks stay widened to '?'.
+            batch_patterns_[i] = pattern_;
+            batch_masks_[i] = masks_;
+            byte_masks_.clear();
+        }
+
+        batch_expected_ = find_batch_offsets(data_, size_, batch_patterns_, batch_masks_);
+        expected_ = batch_expected_.back();
+    }
+
+    // Plants every catalog signature 2 to 10 times, over the region left by the previous tests.
+    void generate_catalog_case()
+    {
+        const std::vector<catalog_signature>& catalog = static_catalog();
+        batch_patterns_.resize(catalog.size());
+        batch_masks_.resize(catalog.size());
+
+        std::uniform_int_distribution<size_t> count_dist(2, 10);
+
+        for (size_t i = 0; i < catalog.size(); ++i)
+        {
+            pattern_ = catalog[i].pattern;
+            masks_ = catalog[i].masks;
+
+            std::uniform_int_distribution<size_t> range_dist(0, size() - pattern_.size());
+            for (size_t k = count_dist(rng_); k != 0; --k)
+                plant_match(range_dist(rng_));
+
+            batch_patterns_[i] = pattern_;
+            batch_masks_[i] = masks_;
+        }
+
+        batch_expected_ = find_batch_offsets(data_, size_, batch_patterns_, batch_masks_);
+        expected_ = batch_expected_.back();
+    }
+
+    // Flips one exact byte of every match that starts in the first length - pattern_length + 1 bytes.
+    void break_matches(size_t length)
+    {
+        std::vector<size_t> exact_positions;
+        for (size_t j = 0; j < pattern_.size(); ++j)
+        {
+            if (masks_[j] == 'x')
+                exact_positions.push_back(j);
+        }
+
+        // Flipping a byte can in theory complete another candidate, so repeat until the range is clean.
+        for (;;)
+        {
+            const std::vector<const byte*> early = find_expected(length);
+            if (early.empty())
+                break;
+
+            for (const byte* hit : early)
+            {
+                const size_t j = exact_positions[rng_() % exact_positions.size()];
+                data_[(hit - data_) + j] ^= 0x01;
+            }
+        }
+    }
+
+    // Plants the first true hit at FIRST_MATCH_DEPTH (clamped to the end of the region), plus a few later hits.
+    // Accidental matches in front of it are broken up so the depth is exact.
+    void generate_first_match_case()
+    {
+        generate_random_pattern();
+
+        const size_t last_start = size_ - pattern_.size();
+        const size_t depth = (std::min)(FIRST_MATCH_DEPTH, last_start);
+
+        plant_match(depth);
+        break_matches(depth + pattern_.size() - 1);
+
+        if (depth < last_start)
+        {
+            std::uniform_int_distribution<size_t> range_dist(depth + 1, last_start);
+            const size_t extra_count = rng_() % 3u;
+            for (size_t i = 0; i < extra_count; ++i)
+                plant_match(range_dist(rng_));
+        }
+    }
+
+    // Clears every accidental match, then plants UNIQUENESS_CASE->hits matches (or a flood) at random offsets.
+    void generate_uniqueness_case()
+    {
+        generate_random_pattern();
+        break_matches(size_);
+
+        const size_t last_start = size_ - pattern_.size();
+        std::uniform_int_distribution<size_t> range_dist(0, last_start);
+
+        if (UNIQUENESS_CASE->hits == SIZE_MAX)
+        {
+            for (size_t offset = range_dist(rng_) % UNIQUENESS_FLOOD_STRIDE; offset <= last_start;
+                 offset += UNIQUENESS_FLOOD_STRIDE)
+                plant_match(offset);
+            return;
+        }
+
+        for (size_t i = 0; i < UNIQUENESS_CASE->hits; ++i)
+            plant_match(range_dist(rng_));
+    }
+
+    void generate_synthetic_realistic_case()
+    {
+        size_t pattern_length = pick_realistic_pattern_length();
+        if (pattern_length > size_)
+            pattern_length = size_;
+
+        pattern_.resize(pattern_length);
+        masks_.resize(pattern_length);
+
+        const size_t source_offset = align_hit_offset(rng_() % (size_ - pattern_length + 1));
+        std::memcpy(pattern_.data(), data_ + source_offset, pattern_length);
+
+        std::bernoulli_distribution wildcard_dist(pick_realistic_wildcard_rate());
+        bool any_exact = false;
+        std::vector<size_t> exact_positions;
+        exact_positions.reserve(pattern_length);
+        for (size_t i = 0; i < pattern_length; ++i)
+        {
+            if (wildcard_dist(rng_))
+            {
+                masks_[i] = '?';
+                pattern_[i] = 0x00;
+            }
+            else
+            {
+                masks_[i] = 'x';
+                any_exact = true;
+                exact_positions.push_back(i);
+            }
+        }
+
+        if (!any_exact)
+        {
+            const size_t force = rng_() % pattern_length;
+            masks_[force] = 'x';
+            pattern_[force] = data_[source_offset + force];
+            exact_positions.push_back(force);
+        }
+
+        const size_t min_exact = (std::min)(static_cast<size_t>(4), pattern_length);
+        while (exact_positions.size() < min_exact)
+        {
+            const size_t pos = rng_() % pattern_length;
+            if (masks_[pos] == 'x')
+                continue;
+            masks_[pos] = 'x';
+            pattern_[pos] = data_[source_offset + pos];
+            exact_positions.push_back(pos);
+        }
+
+        std::array<bool, 256> seen {};
+        size_t distinct_exact = 0;
+        for (size_t pos : exact_positions)
+        {
+            const byte v = pattern_[pos];
+            if (!seen[v])
             {
-                if (masks_[j] == 'x')
-                    data_[off + j] = pattern_[j];
+                seen[v] = true;
+                ++distinct_exact;
             }
         }
+        if (distinct_exact <= 1 && !exact_positions.empty())
+        {
+            const size_t pivot = exact_positions[rng_() % exact_positions.size()];
+            pattern_[pivot] = pick_rarest_data_byte();
+        }
+
+        if (SYNTHETIC_CORPUS == synthetic_corpus::modrm)
+            apply_modrm_masks(exact_positions);
+
+        // Ensure at least one guaranteed true match in-buffer.
+        plant_match(source_offset);
+
+        // Keep real hit density low-to-moderate.
+        const size_t extra_hit_count = rng_() % 3u; // 0..2 additional hits
+        for (size_t i = 0; i < extra_hit_count; ++i)
+            plant_match(align_hit_offset(rng_() % (size_ - pattern_length + 1)));
 
         // Add a few near-misses to prevent trivial always-hit streaks.
         if (!exact_positions.empty())
@@ -1319,12 +2334,8 @@ private:
             const size_t near_miss_count = rng_() % 3u; // 0..2 near misses
             for (size_t i = 0; i < near_miss_count; ++i)
             {
-                const size_t off = rng_() % (size_ - pattern_length + 1);
-                for (size_t j = 0; j < pattern_length; ++j)
-                {
-                    if (masks_[j] == 'x')
-                        data_[off + j] = pattern_[j];
-                }
+                const size_t off = align_hit_offset(rng_() % (size_ - pattern_length + 1));
+                plant_match(off);
 
                 const size_t exact_j = exact_positions[rng_() % exact_positions.size()];
                 data_[off + exact_j] ^= 0x01;
@@ -1344,6 +2355,7 @@ public:
     ~scan_bench()
     {
         mem::protect_free(raw_data_, raw_size_);
+        mem::protect_free(region_raw_, region_raw_size_);
     }
 
     void reset(size_t region_size)
@@ -1388,6 +2400,85 @@ public:
         }
     }
 
+    // Splits the region into pages-sized regions (log-uniform between 1 and max_pages pages), each mapped separately
+    // with a PROT_NONE page in front of and behind it. The layout only depends on the seed and max_pages.
+    void layout_regions(size_t max_pages)
+    {
+        const size_t page_size = mem::page_size();
+        const size_t total_pages = full_size_ / page_size;
+
+        std::mt19937 layout_rng(seed_ ^ static_cast<uint32_t>(max_pages));
+        std::uniform_real_distribution<double> log_dist(0.0, std::log(double(max_pages) + 1.0));
+
+        std::vector<size_t> pages;
+        for (size_t left = total_pages; left != 0;)
+        {
+            const size_t count = (std::min)(left, (std::max)(size_t(1), static_cast<size_t>(std::exp(log_dist(layout_rng)))));
+            pages.push_back(count);
+            left -= count;
+        }
+
+        mem::protect_free(region_raw_, region_raw_size_);
+
+        region_raw_size_ = (total_pages + pages.size() + 1) * page_size;
+        region_raw_ = static_cast<byte*>(mem::protect_alloc(region_raw_size_, mem::prot_flags::RW));
+
+        regions_.clear();
+        region_offsets_.clear();
+
+        byte* cursor = region_raw_;
+        size_t offset = 0;
+
+        mem::protect_modify(cursor, page_size, mem::prot_flags::NONE);
+        cursor += page_size;
+
+        for (const size_t count : pages)
+        {
+            regions_.push_back({cursor, count * page_size});
+            region_offsets_.push_back(offset);
+
+            cursor += count * page_size;
+            offset += count * page_size;
+
+            mem::protect_modify(cursor, page_size, mem::prot_flags::NONE);
+            cursor += page_size;
+        }
+    }
+
+    const std::vector<scan_region>& regions() const noexcept
+    {
+        return regions_;
+    }
+
+    // Expected offsets (into data()) of the matches that lie entirely inside one region.
+    const std::unordered_set<size_t>& region_expected_offsets() const noexcept
+    {
+        return region_expected_;
+    }
+
+    // Maps matches found in regions() back to offsets into data().
+    std::unordered_set<size_t> region_results(const std::vector<const byte*>& results) const
+    {
+        std::unordered_set<size_t> shifted;
+
+        for (const byte* result : results)
+        {
+            const auto next = std::upper_bound(regions_.begin(), regions_.end(), result,
+                [](const byte* value, const scan_region& region) { return value < region.data; });
+
+            if (next == regions_.begin())
+            {
+                shifted.emplace(SIZE_MAX);
+                continue;
+            }
+
+            const size_t index = static_cast<size_t>((next - regions_.begin()) - 1);
+            shifted.emplace(region_offsets_[index] + static_cast<size_t>(result - regions_[index].data));
+        }
+
+        return shifted;
+    }
+
     size_t full_size() const noexcept
     {
         return full_size_;
@@ -1413,6 +2504,20 @@ public:
         return masks_.data();
     }
 
+    // Empty unless the current pattern has per-byte bit masks.
+    const std::vector<byte>& byte_masks() const noexcept
+    {
+        return byte_masks_;
+    }
+
+    std::unique_ptr<compiled_pattern> compile(const pattern_scanner& scanner) const
+    {
+        if (!byte_masks_.empty())
+            return scanner.CompileMasked(pattern(), byte_masks_.data(), pattern_.size());
+
+        return scanner.Compile(pattern(), masks());
+    }
+
     uint32_t seed() const noexcept
     {
         return seed_;
@@ -1423,6 +2528,36 @@ public:
         return expected_;
     }
 
+    const match_bitmap& expected_bitmap() const noexcept
+    {
+        return expected_bitmap_;
+    }
+
+    size_t batch_count() const noexcept
+    {
+        return batch_patterns_.size();
+    }
+
+    const std::vector<std::vector<byte>>& batch_patterns() const noexcept
+    {
+        return batch_patterns_;
+    }
+
+    const std::vector<std::string>& batch_masks() const noexcept
+    {
+        return batch_masks_;
+    }
+
+    const std::unordered_set<size_t>& batch_expected_offsets(size_t index) const noexcept
+    {
+        return batch_expected_[index];
+    }
+
+    size_t expected_first() const
+    {
+        return expected_.empty() ? SIZE_MAX : *std::min_element(expected_.begin(), expected_.end());
+    }
+
     std::unordered_set<size_t> shift_results(const std::vector<const byte*>& results)
     {
         std::unordered_set<size_t> shifted;
@@ -1437,6 +2572,8 @@ public:
 
     void generate()
     {
+        byte_masks_.clear();
+
         if (PATHOLOGICAL_MODE)
         {
             std::uniform_int_distribution<size_t> size_dist(0, 100);
@@ -1628,26 +2765,84 @@ public:
                     }
                 }
             }
+            else if (std::strcmp(pathological_case, "padding_flood") == 0)
+            {
+                // int3 padding between short functions: runs of 0xCC, each closed by a ret and followed by a
+                // prologue. Every offset inside a run matches, so most of the region is hits.
+                pattern_ = {0xCC, 0xCC, 0x00, 0xCC};
+                masks_ = "xx?x";
+
+                std::uniform_int_distribution<size_t> run_dist(1, 256);
+                static const byte prologue[] = {0xC3, 0x48, 0x89, 0x5C, 0x24, 0x08};
+
+                for (size_t i = 0; i < size_;)
+                {
+                    const size_t run = (std::min)(run_dist(rng_), size_ - i);
+                    std::fill_n(data_ + i, run, static_cast<byte>(0xCC));
+                    i += run;
+
+                    for (size_t k = 0; k < sizeof(prologue) && i < size_; ++k)
+                        data_[i++] = prologue[k];
+                }
+            }
+
+            else if (std::strcmp(pathological_case, "zero_flood") == 0)
+            {
+                // Zero-initialised data with a stray non-zero byte every few KiB, where a run of zeros around a
+                // wildcard pair matches almost everywhere.
+                pattern_.assign(8, 0x00);
+                masks_ = "xxxx??xx";
+
+                std::fill_n(data_, size_, static_cast<byte>(0x00));
+
+                std::uniform_int_distribution<size_t> gap_dist(1, 4096);
+                for (size_t i = gap_dist(rng_); i < size_; i += gap_dist(rng_))
+                    data_[i] = static_cast<byte>(1 + (rng_() % 255));
+            }
 
-            expected_ = shift_results(FindPatternSimple(data(), size(), pattern(), masks()));
+            if (DENSE_MATCH_MODE)
+            {
+                expected_.clear();
+                find_expected_bitmap();
+                return;
+            }
+
+            expected_ = shift_results(find_expected(size()));
             return;
         }
 
         std::uniform_int_distribution<size_t> size_dist(0, 100);
 
-        const size_t variation = size_dist(rng_);
+        // The regions suite tiles the whole buffer, so the region start stays put.
+        const size_t variation = REGION_MAX_PAGES ? 0 : size_dist(rng_);
 
         data_ = full_data_ + variation;
         size_ = full_size_ - variation;
 
-        if (DATA_MODE == data_mode::synthetic_realistic)
+        if (BATCH_PATTERN_COUNT != 0)
+        {
+            generate_batch_case();
+            return;
+        }
+
+        if (CATALOG_MODE)
+        {
+            generate_catalog_case();
+            return;
+        }
+
+        if (FIRST_MATCH_DEPTH != 0)
+            generate_first_match_case();
+        else if (UNIQUENESS_CASE)
+            generate_uniqueness_case();
+        else if (DATA_MODE == data_mode::synthetic_realistic)
         {
             const size_t max_expected_hits = (std::max)(static_cast<size_t>(2048), size_ / 8192);
             const size_t max_attempts = 12;
             for (size_t attempt = 0; attempt < max_attempts; ++attempt)
             {
                 generate_synthetic_realistic_case();
-                expected_ = shift_results(FindPatternSimple(data(), size(), pattern(), masks()));
+                expected_ = shift_results(find_expected(size()));
                 if (expected_.size() <= max_expected_hits)
                     return;
             }
@@ -1655,7 +2850,26 @@ public:
         else
             generate_random_case();
 
-        expected_ = shift_results(FindPatternSimple(data(), size(), pattern(), masks()));
+        expected_ = shift_results(find_expected(size()));
+    }
+
+    // Copies the generated region into regions() and keeps the expected matches that do not straddle two of them.
+    void sync_regions()
+    {
+        const size_t pattern_length = pattern_.size();
+
+        for (size_t i = 0; i < regions_.size(); ++i)
+            std::memcpy(const_cast<byte*>(regions_[i].data), data_ + region_offsets_[i], regions_[i].length);
+
+        region_expected_.clear();
+        for (const size_t offset : expected_)
+        {
+            const auto next = std::upper_bound(region_offsets_.begin(), region_offsets_.end(), offset);
+            const size_t index = static_cast<size_t>((next - region_offsets_.begin()) - 1);
+
+            if ((offset + pattern_length) <= (region_offsets_[index] + regions_[index].length))
+                region_expected_.emplace(offset);
+        }
     }
 
     bool check_results(const pattern_scanner& scanner, const std::vector<const byte*>& results)
@@ -1764,6 +2978,9 @@ void failure_logger::log_failure(
     line << ",\"pathological_case\":\"" << json_escape(PATHOLOGICAL_MODE ? PATHOLOGICAL_CASE : "off") << "\"";
     line << ",\"pattern_hex\":\"" << pattern_hex << "\"";
     line << ",\"mask\":\"" << json_escape(mask) << "\"";
+    if (!reg.byte_masks().empty())
+        line << ",\"byte_masks_hex\":\"" << bytes_to_hex(reg.byte_masks().data(), reg.byte_masks().size()) << "\"";
+    line << ",\"alignment\":" << SCAN_ALIGNMENT;
     line << ",\"data_size\":" << reg.size();
     line << ",\"data_fnv1a64\":\"0x" << std::hex << std::uppercase << data_hash << std::dec << "\"";
     line << ",\"data_file\":\"" << json_escape(data_file) << "\"";
@@ -1785,8 +3002,16 @@ struct scanner_bench_result
     uint64_t elapsed {0};
     uint64_t elapsed_ns {0};
     size_t failed {0};
+    double compile_ns {0.0};
     double cycles_per_byte {0.0};
     double gib_per_sec {0.0};
+    double sink_cycles_per_byte {0.0};
+    double sink_gib_per_sec {0.0};
+    double avg_call_ns {0.0}; // Average wall time of one timed call (first_match and batch suites).
+    double unchunked_gib_per_sec {0.0}; // One scan over the whole contiguous region (chunked and regions suites).
+    double region_overhead_ns {0.0}; // Extra wall time per region over the contiguous scan (regions suite).
+    double find_all_call_ns {0.0}; // Average wall time of a full find-all over the same region (uniqueness suite).
+    bool skipped {false}; // Not run in this configuration (batch_scaling above BATCH_SINGLE_PASS_LIMIT).
 };
 
 struct bench_run_summary
@@ -1797,6 +3022,8 @@ struct bench_run_summary
 
 static bool scanner_bench_result_less(const scanner_bench_result& lhs, const scanner_bench_result& rhs)
 {
+    if (lhs.skipped != rhs.skipped)
+        return rhs.skipped;
     if ((lhs.failed != 0) != (rhs.failed != 0))
         return lhs.failed < rhs.failed;
     return lhs.elapsed < rhs.elapsed;
@@ -1808,6 +3035,9 @@ static void reset_scanner_counters()
     {
         pattern->Elapsed = 0;
         pattern->ElapsedNs = 0;
+        pattern->CompileElapsedNs = 0;
+        pattern->SinkElapsed = 0;
+        pattern->SinkElapsedNs = 0;
         pattern->Failed = 0;
     }
 }
@@ -1821,11 +3051,16 @@ static bench_run_summary run_benchmark(
     const char* corpus_label = (DATA_MODE == data_mode::synthetic_realistic) ? synthetic_corpus_name(SYNTHETIC_CORPUS) : "off";
 
     fmt::print(
-        "Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, DataMode: {}, Corpus: {}, Pathological: {}, Case: {}\n",
+        "Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, DataMode: {}, Corpus: {}, Pathological: {}, Case: {}, Align: {}\n",
         run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), data_mode_name(DATA_MODE),
-        corpus_label, PATHOLOGICAL_MODE, PATHOLOGICAL_MODE ? PATHOLOGICAL_CASE : "off");
+        corpus_label, PATHOLOGICAL_MODE, PATHOLOGICAL_MODE ? PATHOLOGICAL_CASE : "off", SCAN_ALIGNMENT);
 
     mem::execution_handler handler;
+    size_t tests_run = 0;
+
+    // Reused across tests so the sink path never allocates while being timed.
+    std::vector<const byte*> sink_buffer;
+
     for (size_t i = 0; i < test_count; ++i)
     {
         reg.generate();
@@ -1833,6 +3068,9 @@ static bench_run_summary run_benchmark(
         if (test_index != SIZE_MAX && i != test_index)
             continue;
 
+        // One spare slot, so a scanner reporting extra matches overflows instead of hiding them.
+        sink_buffer.resize(reg.expected_offsets().size() + 1);
+
         if (LOG_LEVEL > 0 && test_index == SIZE_MAX)
         {
             if (!(i % progress_step) || (i + 1 == test_count))
@@ -1848,15 +3086,55 @@ static bench_run_summary run_benchmark(
             if (skip_fails && pattern->Failed != 0)
                 continue;
 
-            const auto start_time = std::chrono::steady_clock::now();
-            const uint64_t start_clock = bench_rdtsc();
-
             try
             {
-                std::vector<const byte*> results =
-                    handler.execute([&] { return pattern->Scan(reg.pattern(), reg.masks(), reg.data(), reg.size()); });
+                const auto compile_start_time = std::chrono::steady_clock::now();
+
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                const auto compile_end_time = std::chrono::steady_clock::now();
 
-                if (!reg.check_results(*pattern, results))
+                pattern->CompileElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(compile_end_time - compile_start_time).count());
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                std::vector<const byte*> results = handler.execute(
+                    [&] { return pattern->ScanAligned(*compiled, reg.data(), reg.size(), SCAN_ALIGNMENT); });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                match_sink sink(sink_buffer.data(), sink_buffer.size());
+
+                const auto sink_start_time = std::chrono::steady_clock::now();
+                const uint64_t sink_start_clock = bench_rdtsc();
+
+                handler.execute([&] { pattern->ScanAligned(*compiled, reg.data(), reg.size(), SCAN_ALIGNMENT, sink); });
+
+                const uint64_t sink_end_clock = bench_rdtsc();
+                const auto sink_end_time = std::chrono::steady_clock::now();
+
+                pattern->SinkElapsed += sink_end_clock - sink_start_clock;
+                pattern->SinkElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(sink_end_time - sink_start_time).count());
+
+                bool passed = reg.check_results(*pattern, results);
+
+                // Only look at the sink once the vector path agrees with the oracle, so a mismatch logs one set.
+                if (passed)
+                {
+                    results.assign(sink.data(), sink.data() + sink.size());
+                    passed = !sink.overflowed() && reg.check_results(*pattern, results);
+                }
+
+                if (!passed)
                 {
                     const std::unordered_set<size_t> got_set = reg.shift_results(results);
                     const std::vector<size_t> got_sorted = sorted_values(got_set);
@@ -1890,14 +3168,9 @@ static bench_run_summary run_benchmark(
 
                 pattern->Failed++;
             }
+        }
 
-            const uint64_t end_clock = bench_rdtsc();
-            const auto end_time = std::chrono::steady_clock::now();
-
-            pattern->Elapsed += end_clock - start_clock;
-            pattern->ElapsedNs += static_cast<uint64_t>(
-                std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
-        }
+        ++tests_run;
     }
 
     bench_run_summary summary;
@@ -1911,13 +3184,15 @@ static bench_run_summary run_benchmark(
         out.elapsed = pattern->Elapsed;
         out.elapsed_ns = pattern->ElapsedNs;
         out.failed = pattern->Failed;
+        out.compile_ns = tests_run ? (double(pattern->CompileElapsedNs) / tests_run) : 0.0;
         out.cycles_per_byte = double(pattern->Elapsed) / total_scan_length;
+        out.sink_cycles_per_byte = double(pattern->SinkElapsed) / total_scan_length;
+
+        const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
         if (pattern->ElapsedNs != 0)
-        {
-            const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
-            const double elapsed_sec = double(pattern->ElapsedNs) / 1000000000.0;
-            out.gib_per_sec = total_gib / elapsed_sec;
-        }
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        if (pattern->SinkElapsedNs != 0)
+            out.sink_gib_per_sec = total_gib / (double(pattern->SinkElapsedNs) / 1000000000.0);
         summary.results.push_back(out);
     }
 
@@ -1952,6 +3227,8 @@ static void print_run_summary(const bench_run_summary& summary, bool skip_fails)
     size_t elapsed_width = 12;
     size_t cpb_width = 6;
     size_t gib_width = 7;
+    size_t compile_width = 6;
+    size_t sink_gib_width = 7;
     size_t norm_width = 5;
 
     for (size_t i = 0; i < summary.results.size(); ++i)
@@ -1965,6 +3242,8 @@ static void print_run_summary(const bench_run_summary& summary, bool skip_fails)
         elapsed_width = (std::max)(elapsed_width, fmt::format("{}", pattern.elapsed).size());
         cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
         gib_width = (std::max)(gib_width, fmt::format("{:.2f}", pattern.gib_per_sec).size());
+        compile_width = (std::max)(compile_width, fmt::format("{:.0f}", pattern.compile_ns).size());
+        sink_gib_width = (std::max)(sink_gib_width, fmt::format("{:.2f}", pattern.sink_gib_per_sec).size());
 
         const double normalized_perf = (best_perf != 0.0) ? (pattern.cycles_per_byte / best_perf) : 0.0;
         norm_width = (std::max)(norm_width, fmt::format("{:.2f}", normalized_perf).size());
@@ -1984,9 +3263,11 @@ static void print_run_summary(const bench_run_summary& summary, bool skip_fails)
         }
         else
         {
-            fmt::print("{:>{}} cycles = {:>{}.3f} cycles/byte | {:>{}.2f} GiB/s | {:>{}.2f}x", pattern.elapsed,
-                elapsed_width, pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec, gib_width, normalized_perf,
-                norm_width);
+            fmt::print("{:>{}} cycles = {:>{}.3f} cycles/byte | {:>{}.2f} GiB/s | {:>{}.2f}x | compile {:>{}.0f} ns"
+                       " | sink {:>{}.2f} GiB/s",
+                pattern.elapsed, elapsed_width, pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec, gib_width,
+                normalized_perf, norm_width, pattern.compile_ns, compile_width, pattern.sink_gib_per_sec,
+                sink_gib_width);
 
             if (!skip_fails)
                 fmt::print(" | {} failed", pattern.failed);
@@ -1996,21 +3277,1617 @@ static void print_run_summary(const bench_run_summary& summary, bool skip_fails)
     }
 }
 
-struct aggregate_scanner_result
+// Times ScanFirst only. cycles/byte and GiB/s are relative to the bytes in front of (and including) the first hit.
+static bench_run_summary run_first_match_benchmark(
+    scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index, const char* run_label, failure_logger& failures)
 {
-    std::string name;
-    size_t pass_corpora {0};
-    size_t fail_corpora {0};
-    size_t total_failed_tests {0};
-    double geomean_cycles_per_byte {0.0};
-    double arithmetic_cycles_per_byte {0.0};
-};
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Depth: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(),
+        first_match_depth_name(FIRST_MATCH_DEPTH));
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        const size_t expected_first = reg.expected_first();
+        total_scan_length += expected_first + std::strlen(reg.masks());
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            const char* reason = "mismatch";
+            const char* exception_text = nullptr;
+            std::vector<size_t> got_sorted;
+
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                const byte* result = handler.execute([&] { return pattern->ScanFirst(*compiled, reg.data(), reg.size()); });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                if (result && static_cast<size_t>(result - reg.data()) == expected_first)
+                    continue;
+
+                if (result)
+                    got_sorted.push_back(static_cast<size_t>(result - reg.data()));
+            }
+            catch (const std::exception& ex)
+            {
+                reason = "exception";
+                exception_text = ex.what();
+            }
+            catch (...)
+            {
+                reason = "exception";
+                exception_text = "unknown";
+            }
+
+            const std::vector<size_t> expected_sorted {expected_first};
+            failures.log_failure(run_label, i, pattern->GetName(), reg, reason, exception_text,
+                exception_text ? nullptr : &got_sorted, &expected_sorted);
+
+            if (LOG_LEVEL > 1)
+                fmt::print("{0:<32} - Failed test {1} (first hit 0x{2:X})\n", pattern->GetName(), i, expected_first);
+
+            pattern->Failed++;
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    for (const auto& pattern : PATTERN_SCANNERS)
+    {
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.avg_call_ns = tests_run ? (double(pattern->ElapsedNs) / tests_run) : 0.0;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        if (pattern->ElapsedNs != 0)
+        {
+            const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        }
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+static void print_first_match_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    double best_ns = 0.0;
+    size_t name_width = 32;
+    size_t ns_width = 10;
+    size_t cpb_width = 6;
+    size_t norm_width = 5;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if (skip_fails && pattern.failed)
+            continue;
+
+        if (best_ns == 0.0)
+            best_ns = pattern.avg_call_ns;
+
+        ns_width = (std::max)(ns_width, fmt::format("{:.0f}", pattern.avg_call_ns).size());
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        norm_width = (std::max)(
+            norm_width, fmt::format("{:.2f}", (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double normalized = (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0;
+        fmt::print("{:>{}.0f} ns to first result | {:>{}.3f} cycles/byte | {:>{}.2f}x", pattern.avg_call_ns,
+            ns_width, pattern.cycles_per_byte, cpb_width, normalized, norm_width);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+// Times CountMatches(..., 2), which decides 0 / 1 / many, against a full find-all through Scan over the same region.
+static bench_run_summary run_uniqueness_benchmark(
+    scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index, const char* run_label, failure_logger& failures)
+{
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Hits: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), UNIQUENESS_CASE->name);
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+    std::vector<uint64_t> find_all_ns(PATTERN_SCANNERS.size());
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        const size_t expected_count = (std::min)(reg.expected_offsets().size(), size_t(2));
+        total_scan_length += reg.size();
+
+        for (size_t k = 0; k < PATTERN_SCANNERS.size(); ++k)
+        {
+            auto& pattern = PATTERN_SCANNERS[k];
+
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            const char* reason = "mismatch";
+            const char* exception_text = nullptr;
+            std::vector<size_t> got_sorted;
+
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                const size_t count =
+                    handler.execute([&] { return pattern->CountMatches(*compiled, reg.data(), reg.size(), 2); });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                const auto find_all_start = std::chrono::steady_clock::now();
+                const std::vector<const byte*> results =
+                    handler.execute([&] { return pattern->Scan(*compiled, reg.data(), reg.size()); });
+                const auto find_all_end = std::chrono::steady_clock::now();
+
+                find_all_ns[k] += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(find_all_end - find_all_start).count());
+
+                if (count == expected_count)
+                    continue;
+
+                for (size_t j = 0; j < count && j < results.size(); ++j)
+                    got_sorted.push_back(static_cast<size_t>(results[j] - reg.data()));
+            }
+            catch (const std::exception& ex)
+            {
+                reason = "exception";
+                exception_text = ex.what();
+            }
+            catch (...)
+            {
+                reason = "exception";
+                exception_text = "unknown";
+            }
+
+            std::vector<size_t> expected_sorted = sorted_values(reg.expected_offsets());
+            expected_sorted.resize((std::min)(expected_sorted.size(), size_t(2)));
+            failures.log_failure(run_label, i, pattern->GetName(), reg, reason, exception_text,
+                exception_text ? nullptr : &got_sorted, &expected_sorted);
+
+            if (LOG_LEVEL > 1)
+                fmt::print("{0:<32} - Failed test {1} (expected {2} match(es))\n", pattern->GetName(), i,
+                    (expected_count < 2) ? std::to_string(expected_count) : std::string("many"));
+
+            pattern->Failed++;
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    for (size_t k = 0; k < PATTERN_SCANNERS.size(); ++k)
+    {
+        const auto& pattern = PATTERN_SCANNERS[k];
+
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.avg_call_ns = tests_run ? (double(pattern->ElapsedNs) / tests_run) : 0.0;
+        out.find_all_call_ns = tests_run ? (double(find_all_ns[k]) / tests_run) : 0.0;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        if (pattern->ElapsedNs != 0)
+        {
+            const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        }
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+static void print_uniqueness_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    double best_ns = 0.0;
+    size_t name_width = 32;
+    size_t ns_width = 10;
+    size_t cpb_width = 6;
+    size_t norm_width = 5;
+    size_t speedup_width = 5;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if (skip_fails && pattern.failed)
+            continue;
+
+        if (best_ns == 0.0)
+            best_ns = pattern.avg_call_ns;
+
+        const double speedup = (pattern.avg_call_ns != 0.0) ? (pattern.find_all_call_ns / pattern.avg_call_ns) : 0.0;
+
+        ns_width = (std::max)(ns_width, fmt::format("{:.0f}", pattern.avg_call_ns).size());
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        norm_width = (std::max)(
+            norm_width, fmt::format("{:.2f}", (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0).size());
+        speedup_width = (std::max)(speedup_width, fmt::format("{:.2f}", speedup).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double normalized = (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0;
+        const double speedup = (pattern.avg_call_ns != 0.0) ? (pattern.find_all_call_ns / pattern.avg_call_ns) : 0.0;
+        fmt::print("{:>{}.0f} ns to verdict | {:>{}.3f} cycles/byte | {:>{}.2f}x | {:>{}.2f}x vs find-all",
+            pattern.avg_call_ns, ns_width, pattern.cycles_per_byte, cpb_width, normalized, norm_width, speedup,
+            speedup_width);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+// Times ScanBitmap, then ScanVerified into a preallocated pointer sink, over the same dense case. Only the bitmap is
+// compared with the oracle, word by word. The pointer path only has to report the same number of matches.
+static bench_run_summary run_dense_benchmark(
+    scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index, const char* run_label, failure_logger& failures)
+{
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Case: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), PATHOLOGICAL_CASE);
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+    size_t total_matches = 0;
+    size_t total_runs = 0;
+
+    // Reused across tests, so neither timed path allocates.
+    match_bitmap bitmap;
+    std::vector<const byte*> sink_buffer;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        const match_bitmap& expected = reg.expected_bitmap();
+        const size_t expected_count = expected.count();
+
+        total_scan_length += reg.size();
+        total_matches += expected_count;
+        total_runs += expected.runs().size();
+
+        // One spare slot, so a scanner reporting extra matches overflows instead of hiding them.
+        sink_buffer.resize(expected_count + 1);
+        bitmap.reset(reg.size());
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            const char* reason = "mismatch";
+            const char* exception_text = nullptr;
+            std::vector<size_t> got_sorted;
+            std::vector<size_t> expected_sorted;
+
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                handler.execute([&] { pattern->ScanBitmap(*compiled, reg.data(), reg.size(), bitmap); });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                match_sink sink(sink_buffer.data(), sink_buffer.size());
+
+                const auto sink_start_time = std::chrono::steady_clock::now();
+                const uint64_t sink_start_clock = bench_rdtsc();
+
+                handler.execute([&] { pattern->ScanVerified(*compiled, reg.data(), reg.size(), sink); });
+
+                const uint64_t sink_end_clock = bench_rdtsc();
+                const auto sink_end_time = std::chrono::steady_clock::now();
+
+                pattern->SinkElapsed += sink_end_clock - sink_start_clock;
+                pattern->SinkElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(sink_end_time - sink_start_time).count());
+
+                if (bitmap == expected && !sink.overflowed() && sink.size() == expected_count)
+                    continue;
+
+                // Log the offsets of the first differing words, not every match.
+                const size_t words = (bitmap.length() == expected.length()) ? expected.word_count() : 0;
+                for (size_t w = 0; w < words && (got_sorted.size() + expected_sorted.size()) < 64; ++w)
+                {
+                    for (uint64_t diff = bitmap.words()[w] ^ expected.words()[w]; diff; diff &= diff - 1)
+                    {
+                        const size_t offset = w * 64 + static_cast<size_t>(std::countr_zero(diff));
+                        (expected.test(offset) ? expected_sorted : got_sorted).push_back(offset);
+                    }
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                reason = "exception";
+                exception_text = ex.what();
+            }
+            catch (...)
+            {
+                reason = "exception";
+                exception_text = "unknown";
+            }
+
+            failures.log_failure(run_label, i, pattern->GetName(), reg, reason, exception_text,
+                exception_text ? nullptr : &got_sorted, &expected_sorted);
+
+            if (LOG_LEVEL > 1)
+                fmt::print("{0:<32} - Failed test {1} ({2} expected matches)\n", pattern->GetName(), i, expected_count);
+
+            pattern->Failed++;
+        }
+
+        ++tests_run;
+    }
+
+    if (tests_run)
+    {
+        fmt::print("Matches per test: {} in {} runs ({:.1f}% of offsets)\n", total_matches / tests_run,
+            total_runs / tests_run, total_scan_length ? (100.0 * double(total_matches) / double(total_scan_length)) : 0.0);
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    for (const auto& pattern : PATTERN_SCANNERS)
+    {
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        out.sink_cycles_per_byte = total_scan_length ? (double(pattern->SinkElapsed) / total_scan_length) : 0.0;
+
+        const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+        if (pattern->ElapsedNs != 0)
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        if (pattern->SinkElapsedNs != 0)
+            out.sink_gib_per_sec = total_gib / (double(pattern->SinkElapsedNs) / 1000000000.0);
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+static void print_dense_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    double best_perf = 0.0;
+    size_t name_width = 32;
+    size_t cpb_width = 6;
+    size_t gib_width = 7;
+    size_t norm_width = 5;
+    size_t sink_gib_width = 7;
+    size_t speedup_width = 5;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if (skip_fails && pattern.failed)
+            continue;
+
+        if (best_perf == 0.0)
+            best_perf = pattern.cycles_per_byte;
+
+        const double speedup =
+            (pattern.cycles_per_byte != 0.0) ? (pattern.sink_cycles_per_byte / pattern.cycles_per_byte) : 0.0;
+
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        gib_width = (std::max)(gib_width, fmt::format("{:.2f}", pattern.gib_per_sec).size());
+        norm_width = (std::max)(norm_width,
+            fmt::format("{:.2f}", (best_perf != 0.0) ? (pattern.cycles_per_byte / best_perf) : 0.0).size());
+        sink_gib_width = (std::max)(sink_gib_width, fmt::format("{:.2f}", pattern.sink_gib_per_sec).size());
+        speedup_width = (std::max)(speedup_width, fmt::format("{:.2f}", speedup).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double normalized = (best_perf != 0.0) ? (pattern.cycles_per_byte / best_perf) : 0.0;
+        const double speedup =
+            (pattern.cycles_per_byte != 0.0) ? (pattern.sink_cycles_per_byte / pattern.cycles_per_byte) : 0.0;
+        fmt::print("bitmap {:>{}.3f} cycles/byte | {:>{}.2f} GiB/s | {:>{}.2f}x | pointers {:>{}.2f} GiB/s | "
+                   "{:>{}.2f}x vs pointers",
+            pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec, gib_width, normalized, norm_width,
+            pattern.sink_gib_per_sec, sink_gib_width, speedup, speedup_width);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+// Times one ScanMany call per test over the whole batch. cycles/byte is per pattern: cycles / (region bytes * patterns).
+static bench_run_summary run_batch_benchmark(scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index,
+    const char* run_label, failure_logger& failures, size_t single_pass_limit = SIZE_MAX)
+{
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Patterns: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), BATCH_PATTERN_COUNT);
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+
+    std::vector<const byte*> pattern_ptrs;
+    std::vector<const char*> mask_ptrs;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        if (LOG_LEVEL > 0)
+            fmt::print("Benchmark progress [{}]: {}/{}\n", run_label, i + 1, test_count);
+
+        const size_t count = reg.batch_count();
+        pattern_ptrs.resize(count);
+        mask_ptrs.resize(count);
+        for (size_t k = 0; k < count; ++k)
+        {
+            pattern_ptrs[k] = reg.batch_patterns()[k].data();
+            mask_ptrs[k] = reg.batch_masks()[k].c_str();
+        }
+
+        total_scan_length += static_cast<uint64_t>(reg.size()) * count;
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            if (count > single_pass_limit && !pattern->GetTraits().multi_pattern)
+                continue;
+
+            try
+            {
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                const std::vector<std::vector<const byte*>> results = handler.execute(
+                    [&] { return pattern->ScanMany(pattern_ptrs.data(), mask_ptrs.data(), count, reg.data(), reg.size()); });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                for (size_t k = 0; k < count; ++k)
+                {
+                    const std::unordered_set<size_t>& expected = reg.batch_expected_offsets(k);
+                    const std::unordered_set<size_t> got =
+                        (k < results.size()) ? reg.shift_results(results[k]) : std::unordered_set<size_t> {};
+
+                    if (k < results.size() && got.size() == results[k].size() && got == expected)
+                        continue;
+
+                    const std::vector<size_t> got_sorted = sorted_values(got);
+                    const std::vector<size_t> expected_sorted = sorted_values(expected);
+                    failures.log_failure(run_label, i, pattern->GetName(), reg, "batch mismatch", nullptr, &got_sorted,
+                        &expected_sorted);
+
+                    if (LOG_LEVEL > 1)
+                        fmt::print("{0:<32} - Failed test {1}, pattern {2} ({3}, {4})\n", pattern->GetName(), i, k,
+                            mem::as_hex({pattern_ptrs[k], reg.batch_masks()[k].size()}), mask_ptrs[k]);
+
+                    pattern->Failed++;
+                    break;
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", ex.what(), nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1}: {2}\n", pattern->GetName(), i, ex.what());
+
+                pattern->Failed++;
+            }
+            catch (...)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", "unknown", nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1} (Exception)\n", pattern->GetName(), i);
+
+                pattern->Failed++;
+            }
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    for (const auto& pattern : PATTERN_SCANNERS)
+    {
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.skipped = BATCH_PATTERN_COUNT > single_pass_limit && !pattern->GetTraits().multi_pattern;
+        out.avg_call_ns = tests_run ? (double(pattern->ElapsedNs) / tests_run) : 0.0;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        if (pattern->ElapsedNs != 0)
+        {
+            const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        }
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+static void print_batch_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    double best_ns = 0.0;
+    size_t name_width = 32;
+    size_t ms_width = 8;
+    size_t cpb_width = 6;
+    size_t gib_width = 7;
+    size_t norm_width = 5;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if ((skip_fails && pattern.failed) || pattern.skipped)
+            continue;
+
+        if (best_ns == 0.0)
+            best_ns = pattern.avg_call_ns;
+
+        ms_width = (std::max)(ms_width, fmt::format("{:.2f}", pattern.avg_call_ns / 1000000.0).size());
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        gib_width = (std::max)(gib_width, fmt::format("{:.2f}", pattern.gib_per_sec).size());
+        norm_width = (std::max)(
+            norm_width, fmt::format("{:.2f}", (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (pattern.skipped)
+        {
+            fmt::print("skipped (one pass per pattern)\n");
+            continue;
+        }
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double normalized = (best_ns != 0.0) ? (pattern.avg_call_ns / best_ns) : 0.0;
+        fmt::print("{:>{}.2f} ms/batch | {:>{}.3f} cycles/byte/pattern | {:>{}.2f} GiB/s effective | {:>{}.2f}x",
+            pattern.avg_call_ns / 1000000.0, ms_width, pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec,
+            gib_width, normalized, norm_width);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+// One row per scanner with its ms/batch at each set size, in the order of the largest run.
+static void print_batch_scaling_summary(const std::vector<bench_run_summary>& runs, const std::vector<size_t>& counts)
+{
+    if (runs.empty())
+        return;
+
+    size_t name_width = 32;
+    for (const scanner_bench_result& result : runs.back().results)
+        name_width = (std::max)(name_width, result.name.size());
+
+    fmt::print("Batch Scaling (ms/batch, x = time relative to {} patterns)\n\n", counts.front());
+    fmt::print("{:<{}}", "Scanner", name_width);
+    for (size_t count : counts)
+        fmt::print(" | {:>18}", fmt::format("{} patterns", count));
+    fmt::print("\n");
+
+    for (const scanner_bench_result& last : runs.back().results)
+    {
+        fmt::print("{:<{}}", last.name, name_width);
+
+        double first_ns = 0.0;
+        for (const bench_run_summary& run : runs)
+        {
+            const auto found = std::find_if(run.results.begin(), run.results.end(),
+                [&](const scanner_bench_result& result) { return result.name == last.name; });
+
+            if (found == run.results.end() || found->skipped)
+            {
+                fmt::print(" | {:>18}", "skipped");
+                continue;
+            }
+
+            if (found->failed)
+            {
+                fmt::print(" | {:>18}", "failed");
+                continue;
+            }
+
+            if (first_ns == 0.0)
+                first_ns = found->avg_call_ns;
+
+            const double growth = (first_ns != 0.0) ? (found->avg_call_ns / first_ns) : 0.0;
+            fmt::print(" | {:>18}", fmt::format("{:.2f} ({:.1f}x)", found->avg_call_ns / 1000000.0, growth));
+        }
+
+        fmt::print("\n");
+    }
+
+    fmt::print("\n");
+}
+
+static const char* const STATIC_CATALOG_NAME = "static_signature (compile-time)";
+
+// Checks one catalog signature's results against the oracle, logging a mismatch.
+static bool check_catalog_results(scan_bench& reg, size_t index, const std::vector<const byte*>& results,
+    const char* scanner_name, const char* run_label, size_t test, failure_logger& failures)
+{
+    const std::unordered_set<size_t>& expected = reg.batch_expected_offsets(index);
+    const std::unordered_set<size_t> got = reg.shift_results(results);
+    if (got.size() == results.size() && got == expected)
+        return true;
+
+    const std::vector<size_t> got_sorted = sorted_values(got);
+    const std::vector<size_t> expected_sorted = sorted_values(expected);
+    failures.log_failure(run_label, test, scanner_name, reg, "catalog mismatch", nullptr, &got_sorted, &expected_sorted);
+
+    if (LOG_LEVEL > 1)
+        fmt::print("{0:<32} - Failed test {1}, signature {2}\n", scanner_name, test, static_catalog()[index].text);
+
+    return false;
+}
+
+// Scans the region once per catalog signature. Runtime scanners compile each signature from its bytes and mask
+// (the compile column) before scanning it. The static_signature row did all of that at build time, so the gap
+// between it and a runtime scanner is what runtime pattern processing costs.
+static bench_run_summary run_catalog_benchmark(
+    scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index, const char* run_label, failure_logger& failures)
+{
+    reset_scanner_counters();
+
+    const std::vector<catalog_signature>& catalog = static_catalog();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Signatures: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), catalog.size());
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+
+    uint64_t static_elapsed = 0;
+    uint64_t static_elapsed_ns = 0;
+    size_t static_failed = 0;
+
+    std::vector<const byte*> results;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        if (LOG_LEVEL > 0)
+            fmt::print("Benchmark progress [{}]: {}/{}\n", run_label, i + 1, test_count);
+
+        total_scan_length += static_cast<uint64_t>(reg.size()) * catalog.size();
+
+        for (size_t k = 0; k < catalog.size(); ++k)
+        {
+            results.clear();
+            match_sink sink(results);
+
+            const auto start_time = std::chrono::steady_clock::now();
+            const uint64_t start_clock = bench_rdtsc();
+
+            catalog[k].scan(reg.data(), reg.size(), sink);
+
+            const uint64_t end_clock = bench_rdtsc();
+            const auto end_time = std::chrono::steady_clock::now();
+
+            static_elapsed += end_clock - start_clock;
+            static_elapsed_ns += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+            if (!check_catalog_results(reg, k, results, STATIC_CATALOG_NAME, run_label, i, failures))
+                ++static_failed;
+        }
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            try
+            {
+                for (size_t k = 0; k < catalog.size(); ++k)
+                {
+                    const auto compile_start_time = std::chrono::steady_clock::now();
+
+                    const std::unique_ptr<compiled_pattern> compiled = handler.execute(
+                        [&] { return pattern->Compile(catalog[k].pattern.data(), catalog[k].masks.c_str()); });
+
+                    const auto compile_end_time = std::chrono::steady_clock::now();
+
+                    pattern->CompileElapsedNs += static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(compile_end_time - compile_start_time)
+                            .count());
+
+                    results.clear();
+                    match_sink sink(results);
+
+                    const auto start_time = std::chrono::steady_clock::now();
+                    const uint64_t start_clock = bench_rdtsc();
+
+                    handler.execute([&] { pattern->ScanVerified(*compiled, reg.data(), reg.size(), sink); });
+
+                    const uint64_t end_clock = bench_rdtsc();
+                    const auto end_time = std::chrono::steady_clock::now();
+
+                    pattern->Elapsed += end_clock - start_clock;
+                    pattern->ElapsedNs += static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                    if (!check_catalog_results(reg, k, results, pattern->GetName(), run_label, i, failures))
+                    {
+                        pattern->Failed++;
+                        break;
+                    }
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", ex.what(), nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1}: {2}\n", pattern->GetName(), i, ex.what());
+
+                pattern->Failed++;
+            }
+            catch (...)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", "unknown", nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1} (Exception)\n", pattern->GetName(), i);
+
+                pattern->Failed++;
+            }
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    const auto add_result = [&](const char* name, uint64_t elapsed, uint64_t elapsed_ns, uint64_t compile_ns,
+                                size_t failed) {
+        scanner_bench_result out;
+        out.name = name;
+        out.elapsed = elapsed;
+        out.elapsed_ns = elapsed_ns;
+        out.failed = failed;
+        out.compile_ns = tests_run ? (double(compile_ns) / tests_run) : 0.0;
+        out.avg_call_ns = tests_run ? (double(elapsed_ns) / tests_run) : 0.0;
+        out.cycles_per_byte = total_scan_length ? (double(elapsed) / total_scan_length) : 0.0;
+        if (elapsed_ns != 0)
+        {
+            const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+            out.gib_per_sec = total_gib / (double(elapsed_ns) / 1000000000.0);
+        }
+        summary.results.push_back(out);
+    };
+
+    add_result(STATIC_CATALOG_NAME, static_elapsed, static_elapsed_ns, 0, static_failed);
+    for (const auto& pattern : PATTERN_SCANNERS)
+        add_result(pattern->GetName(), pattern->Elapsed, pattern->ElapsedNs, pattern->CompileElapsedNs, pattern->Failed);
+
+    // Ranked by compile + scan, since the compile step is what the suite is about.
+    std::sort(summary.results.begin(), summary.results.end(),
+        [](const scanner_bench_result& lhs, const scanner_bench_result& rhs) {
+            if ((lhs.failed != 0) != (rhs.failed != 0))
+                return lhs.failed < rhs.failed;
+            return (lhs.avg_call_ns + lhs.compile_ns) < (rhs.avg_call_ns + rhs.compile_ns);
+        });
+    return summary;
+}
+
+// ms per catalog pass, split into compile and scan, relative to the static_signature row.
+static void print_catalog_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    const auto baseline = std::find_if(summary.results.begin(), summary.results.end(),
+        [](const scanner_bench_result& result) { return result.name == STATIC_CATALOG_NAME; });
+    const double static_ns = (baseline != summary.results.end()) ? baseline->avg_call_ns : 0.0;
+
+    size_t name_width = 32;
+    for (const scanner_bench_result& pattern : summary.results)
+        name_width = (std::max)(name_width, pattern.name.size());
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double total_ns = pattern.avg_call_ns + pattern.compile_ns;
+        fmt::print("{:>8.3f} ms/catalog | scan {:>7.3f} cycles/byte/pattern | compile {:>9.0f} ns | {:>6.2f}x static",
+            total_ns / 1000000.0, pattern.cycles_per_byte, pattern.compile_ns,
+            (static_ns != 0.0) ? (total_ns / static_ns) : 0.0);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+// Fits the Auto decision table to this machine. Every Auto engine scans the realistic corpora at four length ranges and
+// the pathological cases, once over the whole region and once over its first 64 KiB. Each cell keeps the engine with
+// the lowest geometric mean cycles/byte over the calls that landed in it. Engines that fail a test are left out of
+// that test, and a cell is only refitted when some engine ran every call in it.
+static bool run_auto_calibration(scan_bench& reg, size_t region_size, size_t test_count, const char* path)
+{
+    const size_t engine_count = auto_scanner::engine_count();
+    const size_t small_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<pattern_scanner>> engines;
+    for (size_t i = 0; i < engine_count; ++i)
+    {
+        engines.push_back(auto_scanner::create_engine(i));
+        fmt::print("Calibration engine {:<24} -> {}\n", auto_scanner::engine_name(i),
+            engines[i] ? engines[i]->GetName() : "unavailable");
+    }
+
+    struct cell_stats
+    {
+        size_t calls {0};
+        std::vector<double> log_cpb;
+        std::vector<size_t> runs;
+    };
+
+    std::vector<cell_stats> cells(auto_scanner::cell_count);
+    for (cell_stats& cell : cells)
+    {
+        cell.log_cpb.assign(engine_count, 0.0);
+        cell.runs.assign(engine_count, 0);
+    }
+
+    mem::execution_handler handler;
+    std::vector<const byte*> results;
+
+    auto calibrate_test = [&] {
+        reg.generate();
+
+        const size_t pattern_length = std::strlen(reg.masks());
+        const compiled_pattern shape = reg.byte_masks().empty()
+            ? compiled_pattern(reg.pattern(), reg.masks())
+            : compiled_pattern(reg.pattern(), reg.byte_masks().data(), pattern_length);
+
+        const size_t lengths[2] {reg.size(), (std::min)(reg.size(), small_size)};
+        size_t cell_ids[2];
+        for (size_t k = 0; k < 2; ++k)
+        {
+            cell_ids[k] = auto_scanner::cell_of(auto_scanner::measure(shape, reg.data(), lengths[k]));
+            ++cells[cell_ids[k]].calls;
+        }
+
+        for (size_t e = 0; e < engine_count; ++e)
+        {
+            if (!engines[e])
+                continue;
+
+            uint64_t cycles[2] {UINT64_MAX, UINT64_MAX};
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*engines[e]); });
+
+                for (size_t k = 0; k < 2; ++k)
+                {
+                    // The small slice is fast enough to be noisy, so it keeps the best of eight.
+                    for (size_t rep = 0; rep < (k ? 8 : 1); ++rep)
+                    {
+                        results.clear();
+                        match_sink sink(results);
+
+                        const uint64_t start_clock = bench_rdtsc();
+                        handler.execute([&] { engines[e]->ScanVerified(*compiled, reg.data(), lengths[k], sink); });
+                        const uint64_t end_clock = bench_rdtsc();
+
+                        cycles[k] = (std::min)(cycles[k], end_clock - start_clock);
+                    }
+
+                    if (k == 0 && !reg.check_results(*engines[e], results))
+                        break;
+                }
+            }
+            catch (...)
+            {
+                continue;
+            }
+
+            if (cycles[1] == UINT64_MAX)
+                continue;
+
+            for (size_t k = 0; k < 2; ++k)
+            {
+                cell_stats& cell = cells[cell_ids[k]];
+                cell.log_cpb[e] += std::log((std::max)(double(cycles[k]), 1.0) / double(lengths[k]));
+                ++cell.runs[e];
+            }
+        }
+    };
+
+    static const synthetic_corpus corpora[] {synthetic_corpus::mixed, synthetic_corpus::code,
+        synthetic_corpus::structured, synthetic_corpus::text, synthetic_corpus::padding, synthetic_corpus::entropy,
+        synthetic_corpus::modrm};
+    static const size_t length_ranges[][2] {{6, 12}, {13, 32}, {33, 128}, {129, 1024}};
+
+    const size_t saved_length_min = REALISTIC_LENGTH_MIN;
+    const size_t saved_length_max = REALISTIC_LENGTH_MAX;
+
+    for (const synthetic_corpus corpus : corpora)
+    {
+        for (const auto& range : length_ranges)
+        {
+            SYNTHETIC_CORPUS = corpus;
+            DATA_MODE = data_mode::synthetic_realistic;
+            PATHOLOGICAL_MODE = false;
+            PATHOLOGICAL_CASE = "off";
+            REALISTIC_LENGTH_MIN = range[0];
+            REALISTIC_LENGTH_MAX = range[1];
+            LONG_PATTERN_MODE = range[0] >= LONG_PATTERN_LENGTH_MIN;
+
+            fmt::print("Calibrating corpus:{} length {}-{}\n", synthetic_corpus_name(corpus), range[0], range[1]);
+
+            reg.reset(region_size);
+            for (size_t i = 0; i < test_count; ++i)
+                calibrate_test();
+        }
+    }
+
+    REALISTIC_LENGTH_MIN = saved_length_min;
+    REALISTIC_LENGTH_MAX = saved_length_max;
+    LONG_PATTERN_MODE = false;
+
+    for (const char* pathological_case : PATHOLOGICAL_CASES)
+    {
+        PATHOLOGICAL_MODE = true;
+        PATHOLOGICAL_CASE = pathological_case;
+        DATA_MODE = data_mode::random;
+
+        fmt::print("Calibrating pathological:{}\n", pathological_case);
+
+        reg.reset(region_size);
+        for (size_t i = 0; i < test_count; ++i)
+            calibrate_test();
+    }
+
+    PATHOLOGICAL_MODE = false;
+    PATHOLOGICAL_CASE = "off";
+
+    auto_scanner::decision_table fitted = auto_scanner::table();
+    size_t fitted_cells = 0;
+
+    fmt::print("\n{:<70} | {:>5} | {:<24} | {:>9} | {:>9}\n", "cell", "calls", "engine", "geo cpb", "was cpb");
+    for (size_t c = 0; c < auto_scanner::cell_count; ++c)
+    {
+        const cell_stats& cell = cells[c];
+        if (cell.calls == 0)
+            continue;
+
+        size_t best = engine_count;
+        for (size_t e = 0; e < engine_count; ++e)
+        {
+            if (cell.runs[e] == cell.calls &&
+                (best == engine_count || cell.log_cpb[e] < cell.log_cpb[best]))
+                best = e;
+        }
+
+        if (best == engine_count)
+            continue;
+
+        const size_t was = fitted[c];
+        const double best_cpb = std::exp(cell.log_cpb[best] / double(cell.calls));
+        const double was_cpb = (cell.runs[was] == cell.calls) ? std::exp(cell.log_cpb[was] / double(cell.calls)) : 0.0;
+
+        fmt::print("{:<70} | {:>5} | {:<24} | {:>9.3f} | {:>9.3f}\n", auto_scanner::describe_cell(c), cell.calls,
+            auto_scanner::engine_name(best), best_cpb, was_cpb);
+
+        fitted[c] = static_cast<uint8_t>(best);
+        ++fitted_cells;
+    }
+
+    fmt::print("\nFitted {} of {} cells, the rest keep their engine\n", fitted_cells, auto_scanner::cell_count);
+
+    auto_scanner::set_table(fitted);
+    if (!auto_scanner::save_table(path, fitted))
+    {
+        fmt::print("Cannot write decision table to {}\n", path);
+        return false;
+    }
+
+    fmt::print("Decision table written to {}\n", path);
+    return true;
+}
+
+// Feeds the region through stream_scanner in chunk_size pieces and compares against one ScanVerified over the whole
+// region. The main throughput columns are the chunked ones.
+static bench_run_summary run_chunked_benchmark(scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index,
+    size_t chunk_size, const char* run_label, failure_logger& failures)
+{
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Chunk: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), byte_size_name(chunk_size));
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+
+    std::vector<const byte*> full_results;
+    std::vector<size_t> chunked_results;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        if (LOG_LEVEL > 0)
+            fmt::print("Benchmark progress [{}]: {}/{}\n", run_label, i + 1, test_count);
+
+        total_scan_length += reg.size();
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                full_results.clear();
+                match_sink sink(full_results);
+
+                const auto full_start_time = std::chrono::steady_clock::now();
+                const uint64_t full_start_clock = bench_rdtsc();
+
+                handler.execute([&] { pattern->ScanVerified(*compiled, reg.data(), reg.size(), sink); });
+
+                const uint64_t full_end_clock = bench_rdtsc();
+                const auto full_end_time = std::chrono::steady_clock::now();
+
+                pattern->SinkElapsed += full_end_clock - full_start_clock;
+                pattern->SinkElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(full_end_time - full_start_time).count());
+
+                stream_scanner stream(*pattern, *compiled);
+                chunked_results.clear();
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                handler.execute([&] {
+                    for (size_t pos = 0; pos < reg.size(); pos += chunk_size)
+                        stream.Feed(reg.data() + pos, (std::min)(chunk_size, reg.size() - pos), chunked_results);
+                });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                const std::unordered_set<size_t> got(chunked_results.begin(), chunked_results.end());
+                if (got.size() != chunked_results.size() || got != reg.expected_offsets())
+                {
+                    const std::vector<size_t> got_sorted = sorted_values(got);
+                    const std::vector<size_t> expected_sorted = sorted_values(reg.expected_offsets());
+                    failures.log_failure(run_label, i, pattern->GetName(), reg, "mismatch", nullptr, &got_sorted, &expected_sorted);
+
+                    if (LOG_LEVEL > 1)
+                        fmt::print("{0:<32} - Failed test {1} ({2}, {3})\n", pattern->GetName(), i,
+                            mem::as_hex({reg.pattern(), std::strlen(reg.masks())}), reg.masks());
+
+                    pattern->Failed++;
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", ex.what(), nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1}: {2}\n", pattern->GetName(), i, ex.what());
+
+                pattern->Failed++;
+            }
+            catch (...)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", "unknown", nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1} (Exception)\n", pattern->GetName(), i);
+
+                pattern->Failed++;
+            }
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+    for (const auto& pattern : PATTERN_SCANNERS)
+    {
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        if (pattern->ElapsedNs != 0)
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        if (pattern->SinkElapsedNs != 0)
+            out.unchunked_gib_per_sec = total_gib / (double(pattern->SinkElapsedNs) / 1000000000.0);
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+// Times ScanRegions over the scatter list against ScanVerified over the same bytes laid out contiguously.
+// The difference, divided by the number of regions, is the per-region cost of entering a scan.
+static bench_run_summary run_regions_benchmark(
+    scan_bench& reg, size_t test_count, bool skip_fails, size_t test_index, const char* run_label, failure_logger& failures)
+{
+    reset_scanner_counters();
+
+    fmt::print("Begin Scan [{}]: Seed: 0x{:08X}, Size: 0x{:X}, Tests: {}, Skip Fails: {}, Scanners: {}, Regions: {}\n",
+        run_label, reg.seed(), reg.full_size(), test_count, skip_fails, PATTERN_SCANNERS.size(), reg.regions().size());
+
+    mem::execution_handler handler;
+    size_t tests_run = 0;
+    uint64_t total_scan_length = 0;
+
+    std::vector<const byte*> full_results;
+    std::vector<const byte*> region_results;
+
+    for (size_t i = 0; i < test_count; ++i)
+    {
+        reg.generate();
+
+        if (test_index != SIZE_MAX && i != test_index)
+            continue;
+
+        reg.sync_regions();
+
+        if (LOG_LEVEL > 0)
+            fmt::print("Benchmark progress [{}]: {}/{}\n", run_label, i + 1, test_count);
+
+        total_scan_length += reg.size();
+
+        for (auto& pattern : PATTERN_SCANNERS)
+        {
+            if (skip_fails && pattern->Failed != 0)
+                continue;
+
+            try
+            {
+                const std::unique_ptr<compiled_pattern> compiled =
+                    handler.execute([&] { return reg.compile(*pattern); });
+
+                full_results.clear();
+                match_sink full_sink(full_results);
+
+                const auto full_start_time = std::chrono::steady_clock::now();
+                const uint64_t full_start_clock = bench_rdtsc();
+
+                handler.execute([&] { pattern->ScanVerified(*compiled, reg.data(), reg.size(), full_sink); });
+
+                const uint64_t full_end_clock = bench_rdtsc();
+                const auto full_end_time = std::chrono::steady_clock::now();
+
+                pattern->SinkElapsed += full_end_clock - full_start_clock;
+                pattern->SinkElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(full_end_time - full_start_time).count());
+
+                region_results.clear();
+                match_sink region_sink(region_results);
+
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_clock = bench_rdtsc();
+
+                handler.execute([&] {
+                    pattern->ScanRegions(*compiled, reg.regions().data(), reg.regions().size(), region_sink);
+                });
+
+                const uint64_t end_clock = bench_rdtsc();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                pattern->Elapsed += end_clock - start_clock;
+                pattern->ElapsedNs += static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+
+                const std::unordered_set<size_t> got = reg.region_results(region_results);
+                if (got.size() != region_results.size() || got != reg.region_expected_offsets() ||
+                    reg.shift_results(full_results) != reg.expected_offsets())
+                {
+                    const std::vector<size_t> got_sorted = sorted_values(got);
+                    const std::vector<size_t> expected_sorted = sorted_values(reg.region_expected_offsets());
+                    failures.log_failure(run_label, i, pattern->GetName(), reg, "mismatch", nullptr, &got_sorted, &expected_sorted);
+
+                    if (LOG_LEVEL > 1)
+                        fmt::print("{0:<32} - Failed test {1} ({2}, {3})\n", pattern->GetName(), i,
+                            mem::as_hex({reg.pattern(), std::strlen(reg.masks())}), reg.masks());
+
+                    pattern->Failed++;
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", ex.what(), nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1}: {2}\n", pattern->GetName(), i, ex.what());
+
+                pattern->Failed++;
+            }
+            catch (...)
+            {
+                failures.log_failure(run_label, i, pattern->GetName(), reg, "exception", "unknown", nullptr, nullptr);
+
+                if (LOG_LEVEL > 0)
+                    fmt::print("{0:<32} - Failed test {1} (Exception)\n", pattern->GetName(), i);
+
+                pattern->Failed++;
+            }
+        }
+
+        ++tests_run;
+    }
+
+    bench_run_summary summary;
+    summary.label = run_label;
+
+    const double total_gib = double(total_scan_length) / (1024.0 * 1024.0 * 1024.0);
+    const double region_calls = double(tests_run) * double(reg.regions().size());
+    for (const auto& pattern : PATTERN_SCANNERS)
+    {
+        scanner_bench_result out;
+        out.name = pattern->GetName();
+        out.elapsed = pattern->Elapsed;
+        out.elapsed_ns = pattern->ElapsedNs;
+        out.failed = pattern->Failed;
+        out.cycles_per_byte = total_scan_length ? (double(pattern->Elapsed) / total_scan_length) : 0.0;
+        if (pattern->ElapsedNs != 0)
+            out.gib_per_sec = total_gib / (double(pattern->ElapsedNs) / 1000000000.0);
+        if (pattern->SinkElapsedNs != 0)
+            out.unchunked_gib_per_sec = total_gib / (double(pattern->SinkElapsedNs) / 1000000000.0);
+        if (region_calls != 0.0)
+            out.region_overhead_ns = (double(pattern->ElapsedNs) - double(pattern->SinkElapsedNs)) / region_calls;
+        summary.results.push_back(out);
+    }
+
+    std::sort(summary.results.begin(), summary.results.end(), scanner_bench_result_less);
+    return summary;
+}
+
+static void print_regions_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    size_t name_width = 32;
+    size_t cpb_width = 6;
+    size_t gib_width = 7;
+    size_t full_width = 7;
+    size_t overhead_width = 7;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if (skip_fails && pattern.failed)
+            continue;
+
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        gib_width = (std::max)(gib_width, fmt::format("{:.2f}", pattern.gib_per_sec).size());
+        full_width = (std::max)(full_width, fmt::format("{:.2f}", pattern.unchunked_gib_per_sec).size());
+        overhead_width = (std::max)(overhead_width, fmt::format("{:.1f}", pattern.region_overhead_ns).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        fmt::print("{:>{}.3f} cycles/byte | {:>{}.2f} GiB/s regions | {:>{}.2f} GiB/s contiguous | {:>{}.1f} ns/region",
+            pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec, gib_width, pattern.unchunked_gib_per_sec, full_width,
+            pattern.region_overhead_ns, overhead_width);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+static void print_chunked_summary(const bench_run_summary& summary, bool skip_fails)
+{
+    fmt::print("End Scan [{}]\n\n", summary.label);
+
+    size_t name_width = 32;
+    size_t cpb_width = 6;
+    size_t gib_width = 7;
+    size_t full_width = 7;
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        name_width = (std::max)(name_width, pattern.name.size());
+
+        if (skip_fails && pattern.failed)
+            continue;
+
+        cpb_width = (std::max)(cpb_width, fmt::format("{:.3f}", pattern.cycles_per_byte).size());
+        gib_width = (std::max)(gib_width, fmt::format("{:.2f}", pattern.gib_per_sec).size());
+        full_width = (std::max)(full_width, fmt::format("{:.2f}", pattern.unchunked_gib_per_sec).size());
+    }
+
+    for (const scanner_bench_result& pattern : summary.results)
+    {
+        fmt::print("{:<{}} | ", pattern.name, name_width);
+
+        if (skip_fails && pattern.failed)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double loss = (pattern.unchunked_gib_per_sec != 0.0)
+            ? (100.0 * (1.0 - (pattern.gib_per_sec / pattern.unchunked_gib_per_sec)))
+            : 0.0;
+        fmt::print("{:>{}.3f} cycles/byte | {:>{}.2f} GiB/s chunked | {:>{}.2f} GiB/s whole | {:>6.1f}% loss",
+            pattern.cycles_per_byte, cpb_width, pattern.gib_per_sec, gib_width, pattern.unchunked_gib_per_sec, full_width,
+            loss);
+
+        if (!skip_fails)
+            fmt::print(" | {} failed", pattern.failed);
+
+        fmt::print("\n");
+    }
+}
+
+struct aggregate_scanner_result
+{
+    std::string name;
+    size_t pass_corpora {0};
+    size_t fail_corpora {0};
+    size_t total_failed_tests {0};
+    double geomean_cycles_per_byte {0.0};
+    double arithmetic_cycles_per_byte {0.0};
+};
+
+static bool aggregate_scanner_result_less(const aggregate_scanner_result& lhs, const aggregate_scanner_result& rhs)
+{
+    if ((lhs.fail_corpora != 0) != (rhs.fail_corpora != 0))
+        return lhs.fail_corpora < rhs.fail_corpora;
+    return lhs.geomean_cycles_per_byte < rhs.geomean_cycles_per_byte;
+}
+
+// Pairs every parallel(<name>) with <name> and prints how much faster the threaded scan is, from the geomean cycles
+// per byte over the runs where both passed. Efficiency is speedup / threads, 100% being perfect scaling.
+static void print_parallel_scaling(const bench_run_summary* runs, size_t run_count)
+{
+    if (PARALLEL_THREADS <= 1)
+        return;
+
+    struct scaling_tmp
+    {
+        double sum_log_speedup {0.0};
+        size_t run_count {0};
+    };
+
+    std::vector<std::string> order;
+    std::unordered_map<std::string, scaling_tmp> by_name;
+
+    for (size_t i = 0; i < run_count; ++i)
+    {
+        std::unordered_map<std::string, const scanner_bench_result*> serial;
+        for (const scanner_bench_result& scanner : runs[i].results)
+            serial[scanner.name] = &scanner;
+
+        for (const scanner_bench_result& scanner : runs[i].results)
+        {
+            if (scanner.name.rfind("parallel(", 0) != 0)
+                continue;
+
+            const auto inner = serial.find(scanner.name.substr(9, scanner.name.size() - 10));
+            if (inner == serial.end())
+                continue;
+
+            if (!by_name.count(inner->first))
+                order.push_back(inner->first);
+
+            scaling_tmp& tmp = by_name[inner->first];
+
+            if (scanner.failed || inner->second->failed || scanner.cycles_per_byte <= 0.0 ||
+                inner->second->cycles_per_byte <= 0.0)
+                continue;
+
+            tmp.sum_log_speedup += std::log(inner->second->cycles_per_byte / scanner.cycles_per_byte);
+            tmp.run_count++;
+        }
+    }
 
-static bool aggregate_scanner_result_less(const aggregate_scanner_result& lhs, const aggregate_scanner_result& rhs)
-{
-    if ((lhs.fail_corpora != 0) != (rhs.fail_corpora != 0))
-        return lhs.fail_corpora < rhs.fail_corpora;
-    return lhs.geomean_cycles_per_byte < rhs.geomean_cycles_per_byte;
+    if (order.empty())
+        return;
+
+    size_t name_width = 32;
+    for (const std::string& name : order)
+        name_width = (std::max)(name_width, name.size());
+
+    fmt::print("\nParallel Scaling ({} threads)\n\n", PARALLEL_THREADS);
+
+    for (const std::string& name : order)
+    {
+        const scaling_tmp& tmp = by_name[name];
+        fmt::print("{:<{}} | ", name, name_width);
+
+        if (tmp.run_count == 0)
+        {
+            fmt::print("failed\n");
+            continue;
+        }
+
+        const double speedup = std::exp(tmp.sum_log_speedup / tmp.run_count);
+        fmt::print("{:>6.2f}x speedup | {:>5.1f}% efficiency\n", speedup, 100.0 * speedup / PARALLEL_THREADS);
+    }
 }
 
 static void print_suite_aggregate(const std::vector<bench_run_summary>& runs, bool skip_fails, const char* title)
@@ -2128,6 +5005,8 @@ static void print_suite_aggregate(const std::vector<bench_run_summary>& runs, bo
 
         fmt::print("\n");
     }
+
+    print_parallel_scaling(runs.data(), runs.size());
 }
 
 static mem::cmd_param cmd_region_size {"size"};
@@ -2144,6 +5023,14 @@ static mem::cmd_param cmd_smoke_fuzz {"smoke_fuzz"};
 static mem::cmd_param cmd_data_mode {"data_mode"};
 static mem::cmd_param cmd_corpus {"corpus"};
 static mem::cmd_param cmd_suite {"suite"};
+static mem::cmd_param cmd_batch_patterns {"patterns"};
+static mem::cmd_param cmd_chunk_size {"chunk"};
+static mem::cmd_param cmd_isa {"isa"};
+static mem::cmd_param cmd_align {"align"};
+static mem::cmd_param cmd_pattern_length {"pattern_length"};
+static mem::cmd_param cmd_threads {"threads"};
+static mem::cmd_param cmd_auto_table {"auto_table"};
+static mem::cmd_param cmd_calibrate_auto {"calibrate_auto"};
 static mem::cmd_param cmd_help {"help"};
 static mem::cmd_param cmd_help_short {"h"};
 
@@ -2165,6 +5052,129 @@ static void apply_scanner_filter(const char* filter)
     }
 }
 
+// Caps the detected features at a named ISA level, to compare kernels on one machine. Returns false for unknown names.
+static bool parse_isa_limit(const char* value, uint32_t& out)
+{
+    if (!value || std::strcmp(value, "native") == 0)
+    {
+        out = CPU_ALL;
+        return true;
+    }
+
+    if (std::strcmp(value, "sse2") == 0)
+    {
+        out = CPU_SSE2;
+        return true;
+    }
+
+    if (std::strcmp(value, "sse4.2") == 0)
+    {
+        out = CPU_SSE2 | CPU_SSSE3 | CPU_SSE41 | CPU_SSE42;
+        return true;
+    }
+
+    if (std::strcmp(value, "avx2") == 0)
+    {
+        out = CPU_SSE2 | CPU_SSSE3 | CPU_SSE41 | CPU_SSE42 | CPU_AVX2 | CPU_BMI1 | CPU_BMI2;
+        return true;
+    }
+
+    return false;
+}
+
+// Parses "N" or "MIN-MAX" for --pattern_length. Returns false for zero, inverted or malformed ranges.
+static bool parse_length_range(const char* value, size_t& min_out, size_t& max_out)
+{
+    char* end = nullptr;
+    const unsigned long long min_value = std::strtoull(value, &end, 10);
+    unsigned long long max_value = min_value;
+
+    if (*end == '-')
+        max_value = std::strtoull(end + 1, &end, 10);
+
+    if (end == value || *end != '\0' || min_value == 0 || max_value < min_value)
+        return false;
+
+    min_out = static_cast<size_t>(min_value);
+    max_out = static_cast<size_t>(max_value);
+    return true;
+}
+
+// Drops the scanners whose scanner_traits::isa the host lacks and prints the decision for each of them.
+static void apply_cpu_dispatch(uint32_t features)
+{
+    fmt::print("CPU features: {}\n", CpuFeatureNames(features));
+
+    const size_t total = PATTERN_SCANNERS.size();
+    std::vector<std::string> skipped;
+
+    for (const auto& scanner : PATTERN_SCANNERS)
+    {
+        const scanner_traits traits = scanner->GetTraits();
+        const uint32_t missing = traits.isa & ~features;
+
+        if (missing == 0)
+        {
+            if (LOG_LEVEL > 0)
+            {
+                fmt::print("Dispatch: {:<32} run  (isa: {}, align: {}, overread: {})\n", scanner->GetName(),
+                    traits.isa ? CpuFeatureNames(traits.isa) : "baseline", traits.alignment, traits.overread);
+            }
+            continue;
+        }
+
+        const pattern_scanner* fallback = nullptr;
+        if (traits.fallback)
+        {
+            for (const auto& other : PATTERN_SCANNERS)
+            {
+                if (std::strcmp(other->GetName(), traits.fallback) == 0 && (other->GetTraits().isa & ~features) == 0)
+                    fallback = other.get();
+            }
+        }
+
+        if (fallback)
+            fmt::print("Dispatch: {:<32} skip (needs {}), downgraded to {}\n", scanner->GetName(), CpuFeatureNames(missing),
+                fallback->GetName());
+        else
+            fmt::print("Dispatch: {:<32} skip (needs {})\n", scanner->GetName(), CpuFeatureNames(missing));
+
+        skipped.push_back(scanner->GetName());
+    }
+
+    auto iter = PATTERN_SCANNERS.begin();
+    while (iter != PATTERN_SCANNERS.end())
+    {
+        if (std::find(skipped.begin(), skipped.end(), (*iter)->GetName()) != skipped.end())
+            iter = PATTERN_SCANNERS.erase(iter);
+        else
+            ++iter;
+    }
+
+    fmt::print("Dispatch: {} of {} scanners enabled\n", PATTERN_SCANNERS.size(), total);
+}
+
+// Registers parallel(<name>) on the given number of threads right after each enabled scanner, so both run on the
+// same tests and print_parallel_scaling can pair them up.
+static void add_parallel_scanners(size_t threads)
+{
+    if (threads <= 1)
+        return;
+
+    size_t added = 0;
+    for (auto iter = PATTERN_SCANNERS.begin(); iter != PATTERN_SCANNERS.end(); ++iter)
+    {
+        std::unique_ptr<pattern_scanner> inner = CreatePatternScanner((*iter)->GetName());
+        if (!inner)
+            continue;
+
+        iter = PATTERN_SCANNERS.insert(iter + 1, parallel_scanner::wrap(std::move(inner), threads));
+        ++added;
+    }
+
+    fmt::print("Parallel: {} scanners also run on {} threads\n", added, threads);
+}
+
 static void print_help(const char* exe_name)
 {
     const char* exe = exe_name ? exe_name : "pattern-bench.exe";
@@ -2184,8 +5194,20 @@ static void print_help(const char* exe_name)
     fmt::print("  --smoke_only <true|false>          Run smoke tests and exit\n");
     fmt::print("  --smoke_fuzz <N>                   Randomized smoke cases (default: 32)\n");
     fmt::print("  --data_mode <random|synthetic_realistic>\n");
-    fmt::print("  --corpus <mixed|code|structured|text|padding|entropy|all>\n");
-    fmt::print("  --suite <single|realistic|pathological|combined>\n");
+    fmt::print("  --corpus <mixed|code|structured|text|padding|entropy|modrm|all>\n");
+    fmt::print("  --suite <single|realistic|pathological|combined|first_match|batch|batch_scaling|chunked|uniqueness|"
+               "regions|catalog|long_patterns|dense_matches>\n");
+    fmt::print("  --patterns <N>                     Patterns per ScanMany call in the batch suite (default: 100)\n");
+    fmt::print("                                     batch_scaling runs 10, 100, 1000 and 10000 unless this is set\n");
+    fmt::print("  --chunk <bytes>                    Chunk size for the chunked suite (default: 4KiB..16MiB)\n");
+    fmt::print("  --isa <native|sse2|sse4.2|avx2>    Run only scanners this ISA level supports (default: native)\n");
+    fmt::print("  --align <N>                        Only report matches at this address alignment (default: 1)\n");
+    fmt::print("                                     N is a power of two up to 4096\n");
+    fmt::print("  --pattern_length <N|min-max>       Synthetic realistic pattern lengths (default: mix of 6..32)\n");
+    fmt::print("                                     long_patterns defaults to 64-4096\n");
+    fmt::print("  --threads <N>                      Also run every scanner as parallel(<name>) on N threads\n");
+    fmt::print("  --auto_table <file>                Decision table for the Auto scanner (default: built-in)\n");
+    fmt::print("  --calibrate_auto <file>            Fit the Auto decision table on this machine and write it to file\n");
 }
 
 int main(int argc, char** argv)
@@ -2212,7 +5234,8 @@ int main(int argc, char** argv)
         if (!parse_bench_suite(suite_value, BENCH_SUITE))
         {
             fmt::print("Invalid suite: {}\n", suite_value);
-            fmt::print("Available suites: single, realistic, pathological, combined\n");
+            fmt::print("Available suites: single, realistic, pathological, combined, first_match, batch, "
+                       "batch_scaling, chunked, uniqueness, regions, catalog, long_patterns, dense_matches\n");
             return 1;
         }
     }
@@ -2235,7 +5258,50 @@ int main(int argc, char** argv)
         else if (!parse_synthetic_corpus(corpus_value, SYNTHETIC_CORPUS))
         {
             fmt::print("Invalid corpus: {}\n", corpus_value);
-            fmt::print("Available corpora: mixed, code, structured, text, padding, entropy, all\n");
+            fmt::print("Available corpora: mixed, code, structured, text, padding, entropy, modrm, all\n");
+            return 1;
+        }
+    }
+
+    SCAN_ALIGNMENT = cmd_align.get_or<size_t>(1);
+    if (SCAN_ALIGNMENT == 0 || SCAN_ALIGNMENT > 4096 || (SCAN_ALIGNMENT & (SCAN_ALIGNMENT - 1)) != 0)
+    {
+        fmt::print("Invalid alignment: {} (must be a power of two up to 4096)\n", SCAN_ALIGNMENT);
+        return 1;
+    }
+
+    if (SCAN_ALIGNMENT != 1 &&
+        (BENCH_SUITE == bench_suite::first_match || BENCH_SUITE == bench_suite::batch ||
+            BENCH_SUITE == bench_suite::batch_scaling || BENCH_SUITE == bench_suite::chunked ||
+            BENCH_SUITE == bench_suite::uniqueness || BENCH_SUITE == bench_suite::regions ||
+            BENCH_SUITE == bench_suite::catalog || BENCH_SUITE == bench_suite::dense_matches))
+    {
+        fmt::print("Suite '{}' does not support --align.\n", bench_suite_name(BENCH_SUITE));
+        return 1;
+    }
+
+    if (const char* length_value = cmd_pattern_length.get())
+    {
+        if (!parse_length_range(length_value, REALISTIC_LENGTH_MIN, REALISTIC_LENGTH_MAX))
+        {
+            fmt::print("Invalid pattern length: {} (expected N or min-max)\n", length_value);
+            return 1;
+        }
+    }
+
+    PARALLEL_THREADS = cmd_threads.get_or<size_t>(1);
+    if (PARALLEL_THREADS == 0 || PARALLEL_THREADS > 256)
+    {
+        fmt::print("Invalid thread count: {} (must be 1 to 256)\n", PARALLEL_THREADS);
+        return 1;
+    }
+
+    if (const char* table_path = cmd_auto_table.get())
+    {
+        std::string error;
+        if (!auto_scanner::load_table(table_path, error))
+        {
+            fmt::print("Invalid Auto decision table {}: {}\n", table_path, error);
             return 1;
         }
     }
@@ -2259,8 +5325,18 @@ int main(int argc, char** argv)
     }
 #endif
 
+    uint32_t isa_limit = CPU_ALL;
+    if (!parse_isa_limit(cmd_isa.get(), isa_limit))
+    {
+        fmt::print("Invalid ISA level: {}\n", cmd_isa.get());
+        fmt::print("Available ISA levels: native, sse2, sse4.2, avx2\n");
+        return 1;
+    }
+
     const char* filter = cmd_filter.get();
     apply_scanner_filter(filter);
+    apply_cpu_dispatch(DetectCpuFeatures() & isa_limit);
+    add_parallel_scanners(PARALLEL_THREADS);
 
     if (PATTERN_SCANNERS.empty())
     {
@@ -2308,6 +5384,12 @@ int main(int argc, char** argv)
     const size_t test_index = cmd_test_index.get_or<size_t>(SIZE_MAX);
     const char* file_name = cmd_test_file.get();
 
+    if (const char* calibrate_path = cmd_calibrate_auto.get())
+    {
+        const size_t calibrate_size = cmd_region_size.get_or<size_t>(32 * 1024 * 1024);
+        return run_auto_calibration(reg, calibrate_size, test_count, calibrate_path) ? 0 : 1;
+    }
+
     if (file_name)
     {
         if (BENCH_SUITE != bench_suite::single)
@@ -2342,6 +5424,7 @@ int main(int argc, char** argv)
         out.push_back(synthetic_corpus::text);
         out.push_back(synthetic_corpus::padding);
         out.push_back(synthetic_corpus::entropy);
+        out.push_back(synthetic_corpus::modrm);
         return out;
     };
 
@@ -2411,11 +5494,252 @@ int main(int argc, char** argv)
         reg.reset(region_size);
         const bench_run_summary summary = run_benchmark(reg, test_count, skip_fails, test_index, "single", failures);
         print_run_summary(summary, skip_fails);
+        print_parallel_scaling(&summary, 1);
         fmt::print("Failure records: {}\n", failures.failure_count());
         return 0;
     }
 
     std::vector<bench_run_summary> runs;
+    if (BENCH_SUITE == bench_suite::first_match)
+    {
+        fmt::print("Running suite '{}' with {} depth(s)\n", bench_suite_name(BENCH_SUITE), FIRST_MATCH_DEPTHS.size());
+
+        reg.reset(region_size);
+
+        for (size_t i = 0; i < FIRST_MATCH_DEPTHS.size(); ++i)
+        {
+            FIRST_MATCH_DEPTH = FIRST_MATCH_DEPTHS[i];
+
+            const std::string depth_name = first_match_depth_name(FIRST_MATCH_DEPTH);
+            fmt::print("\nDepth {}/{}: {}\n", i + 1, FIRST_MATCH_DEPTHS.size(), depth_name);
+
+            const std::string run_label = fmt::format("first_match:{}", depth_name);
+            bench_run_summary summary =
+                run_first_match_benchmark(reg, test_count, skip_fails, test_index, run_label.c_str(), failures);
+            print_first_match_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        FIRST_MATCH_DEPTH = 0;
+        print_suite_aggregate(runs, skip_fails, "First Match");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::regions)
+    {
+        fmt::print("Running suite '{}' with {} layout(s)\n", bench_suite_name(BENCH_SUITE), REGION_MAX_PAGES_LIST.size());
+
+        reg.reset(region_size);
+
+        for (size_t i = 0; i < REGION_MAX_PAGES_LIST.size(); ++i)
+        {
+            REGION_MAX_PAGES = REGION_MAX_PAGES_LIST[i];
+            reg.layout_regions(REGION_MAX_PAGES);
+
+            const std::string layout_name = byte_size_name(REGION_MAX_PAGES * mem::page_size());
+            fmt::print("\nLayout {}/{}: {} regions up to {}\n", i + 1, REGION_MAX_PAGES_LIST.size(), reg.regions().size(),
+                layout_name);
+
+            const std::string run_label = fmt::format("regions:{}", layout_name);
+            bench_run_summary summary =
+                run_regions_benchmark(reg, test_count, skip_fails, test_index, run_label.c_str(), failures);
+            print_regions_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        REGION_MAX_PAGES = 0;
+        print_suite_aggregate(runs, skip_fails, "Regions");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::uniqueness)
+    {
+        fmt::print("Running suite '{}' with {} hit count(s)\n", bench_suite_name(BENCH_SUITE), UNIQUENESS_CASES.size());
+
+        reg.reset(region_size);
+
+        for (size_t i = 0; i < UNIQUENESS_CASES.size(); ++i)
+        {
+            UNIQUENESS_CASE = &UNIQUENESS_CASES[i];
+
+            fmt::print("\nHits {}/{}: {}\n", i + 1, UNIQUENESS_CASES.size(), UNIQUENESS_CASE->name);
+
+            const std::string run_label = fmt::format("uniqueness:{}", UNIQUENESS_CASE->name);
+            bench_run_summary summary =
+                run_uniqueness_benchmark(reg, test_count, skip_fails, test_index, run_label.c_str(), failures);
+            print_uniqueness_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        UNIQUENESS_CASE = nullptr;
+        print_suite_aggregate(runs, skip_fails, "Uniqueness");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::dense_matches)
+    {
+        fmt::print("Running suite '{}' with {} dense case(s)\n", bench_suite_name(BENCH_SUITE), DENSE_MATCH_CASES.size());
+
+        DENSE_MATCH_MODE = true;
+
+        for (size_t i = 0; i < DENSE_MATCH_CASES.size(); ++i)
+        {
+            PATHOLOGICAL_MODE = true;
+            PATHOLOGICAL_CASE = DENSE_MATCH_CASES[i];
+            DATA_MODE = data_mode::random;
+
+            fmt::print("\nDense {}/{}: {}\n", i + 1, DENSE_MATCH_CASES.size(), PATHOLOGICAL_CASE);
+
+            reg.reset(region_size);
+
+            const std::string run_label = fmt::format("dense_matches:{}", PATHOLOGICAL_CASE);
+            bench_run_summary summary =
+                run_dense_benchmark(reg, test_count, skip_fails, test_index, run_label.c_str(), failures);
+            print_dense_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        DENSE_MATCH_MODE = false;
+        PATHOLOGICAL_MODE = false;
+        PATHOLOGICAL_CASE = "off";
+        print_suite_aggregate(runs, skip_fails, "Dense Matches");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::batch)
+    {
+        BATCH_PATTERN_COUNT = cmd_batch_patterns.get_or<size_t>(100);
+        if (BATCH_PATTERN_COUNT == 0)
+        {
+            fmt::print("Invalid pattern count\n");
+            return 1;
+        }
+
+        if (DATA_MODE == data_mode::synthetic_realistic)
+            fmt::print("Scanning {} data (corpus: {})\n", data_mode_name(DATA_MODE), synthetic_corpus_name(SYNTHETIC_CORPUS));
+        else
+            fmt::print("Scanning {} data\n", data_mode_name(DATA_MODE));
+
+        reg.reset(region_size);
+
+        const std::string run_label = fmt::format("batch:{}", BATCH_PATTERN_COUNT);
+        const bench_run_summary summary =
+            run_batch_benchmark(reg, test_count, skip_fails, test_index, run_label.c_str(), failures);
+        print_batch_summary(summary, skip_fails);
+
+        BATCH_PATTERN_COUNT = 0;
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::batch_scaling)
+    {
+        std::vector<size_t> counts(BATCH_SCALING_COUNTS.begin(), BATCH_SCALING_COUNTS.end());
+        if (cmd_batch_patterns.get())
+            counts.assign(1, cmd_batch_patterns.get_or<size_t>(0));
+
+        if (counts[0] == 0)
+        {
+            fmt::print("Invalid pattern count\n");
+            return 1;
+        }
+
+        if (DATA_MODE == data_mode::synthetic_realistic)
+            fmt::print("Scanning {} data (corpus: {})\n", data_mode_name(DATA_MODE), synthetic_corpus_name(SYNTHETIC_CORPUS));
+        else
+            fmt::print("Scanning {} data\n", data_mode_name(DATA_MODE));
+
+        std::vector<bench_run_summary> runs;
+        for (size_t count : counts)
+        {
+            BATCH_PATTERN_COUNT = count;
+            reg.reset(region_size);
+
+            const std::string run_label = fmt::format("batch_scaling:{}", count);
+            bench_run_summary summary = run_batch_benchmark(
+                reg, test_count, skip_fails, test_index, run_label.c_str(), failures, BATCH_SINGLE_PASS_LIMIT);
+            print_batch_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        BATCH_PATTERN_COUNT = 0;
+        print_batch_scaling_summary(runs, counts);
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::catalog)
+    {
+        if (DATA_MODE == data_mode::synthetic_realistic)
+            fmt::print("Scanning {} data (corpus: {})\n", data_mode_name(DATA_MODE), synthetic_corpus_name(SYNTHETIC_CORPUS));
+        else
+            fmt::print("Scanning {} data\n", data_mode_name(DATA_MODE));
+
+        CATALOG_MODE = true;
+        reg.reset(region_size);
+
+        const bench_run_summary summary =
+            run_catalog_benchmark(reg, test_count, skip_fails, test_index, "catalog", failures);
+        print_catalog_summary(summary, skip_fails);
+
+        CATALOG_MODE = false;
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::chunked)
+    {
+        std::vector<size_t> chunk_sizes(CHUNK_SIZES.begin(), CHUNK_SIZES.end());
+        if (cmd_chunk_size.get())
+            chunk_sizes.assign(1, cmd_chunk_size.get_or<size_t>(0));
+
+        if (chunk_sizes[0] == 0)
+        {
+            fmt::print("Invalid chunk size\n");
+            return 1;
+        }
+
+        fmt::print("Running suite '{}' with {} chunk size(s)\n", bench_suite_name(BENCH_SUITE), chunk_sizes.size());
+
+        reg.reset(region_size);
+
+        for (size_t i = 0; i < chunk_sizes.size(); ++i)
+        {
+            fmt::print("\nChunk {}/{}: {}\n", i + 1, chunk_sizes.size(), byte_size_name(chunk_sizes[i]));
+
+            const std::string run_label = fmt::format("chunked:{}", byte_size_name(chunk_sizes[i]));
+            bench_run_summary summary = run_chunked_benchmark(
+                reg, test_count, skip_fails, test_index, chunk_sizes[i], run_label.c_str(), failures);
+            print_chunked_summary(summary, skip_fails);
+            runs.push_back(std::move(summary));
+        }
+
+        print_suite_aggregate(runs, skip_fails, "Chunked");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
+    if (BENCH_SUITE == bench_suite::long_patterns)
+    {
+        if (REALISTIC_LENGTH_MIN == 0)
+        {
+            REALISTIC_LENGTH_MIN = LONG_PATTERN_LENGTH_MIN;
+            REALISTIC_LENGTH_MAX = LONG_PATTERN_LENGTH_MAX;
+        }
+
+        LONG_PATTERN_MODE = true;
+        run_realistic(runs, false);
+        LONG_PATTERN_MODE = false;
+
+        print_suite_aggregate(runs, skip_fails, "Long Patterns");
+        fmt::print("Failure records: {}\n", failures.failure_count());
+        return 0;
+    }
+
     if (BENCH_SUITE == bench_suite::realistic)
     {
         run_realistic(runs, false);
@@ -19,19 +19,347 @@
 
 #include "pattern_entry.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 std::vector<std::unique_ptr<pattern_scanner>> PATTERN_SCANNERS;
+std::vector<pattern_scanner* (*)()> PATTERN_FACTORIES;
+
+std::unique_ptr<pattern_scanner> CreatePatternScanner(const char* name)
+{
+    for (pattern_scanner* (*factory)() : PATTERN_FACTORIES)
+    {
+        std::unique_ptr<pattern_scanner> scanner(factory());
+        if (std::strcmp(scanner->GetName(), name) == 0)
+            return scanner;
+    }
+
+    return nullptr;
+}
+
+compiled_pattern::compiled_pattern(const byte* pattern, const char* masks)
+    : bytes(pattern, pattern + strlen(masks))
+    , mask(masks)
+    , byte_mask(mask.size())
+{
+    for (size_t i = 0; i < mask.size(); ++i)
+        byte_mask[i] = (mask[i] == 'x') ? 0xFF : 0x00;
+}
+
+compiled_pattern::compiled_pattern(const byte* pattern, const byte* byte_masks, size_t length)
+    : bytes(length)
+    , mask(length, '?')
+    , byte_mask(byte_masks, byte_masks + length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        bytes[i] = pattern[i] & byte_masks[i];
+
+        if (byte_masks[i] == 0xFF)
+            mask[i] = 'x';
+    }
+}
+
+bool compiled_pattern::has_partial_masks() const noexcept
+{
+    for (byte m : byte_mask)
+    {
+        if (m != 0x00 && m != 0xFF)
+            return true;
+    }
+
+    return false;
+}
+
+bool compiled_pattern::matches(const byte* candidate) const noexcept
+{
+    for (size_t i = 0; i < byte_mask.size(); ++i)
+    {
+        if (((candidate[i] ^ bytes[i]) & byte_mask[i]) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+size_t match_bitmap::count() const noexcept
+{
+    size_t total = 0;
+    for (uint64_t word : words_)
+        total += static_cast<size_t>(std::popcount(word));
+    return total;
+}
+
+std::vector<match_run> match_bitmap::runs() const
+{
+    std::vector<match_run> out;
+
+    for (size_t i = 0; i < words_.size(); ++i)
+    {
+        uint64_t word = words_[i];
+        while (word)
+        {
+            const size_t start = static_cast<size_t>(std::countr_zero(word));
+            const size_t ones = static_cast<size_t>(std::countr_one(word >> start));
+            const size_t offset = i * 64 + start;
+
+            // A run that reaches the top bit continues in the next word when that word starts with a set bit.
+            if (!out.empty() && out.back().offset + out.back().length == offset)
+                out.back().length += ones;
+            else
+                out.push_back({offset, ones});
+
+            word = (start + ones < 64) ? (word & ~(((uint64_t(1) << ones) - 1) << start)) : 0;
+        }
+    }
+
+    return out;
+}
+
+std::unique_ptr<compiled_pattern> pattern_scanner::Compile(const byte* pattern, const char* mask) const
+{
+    return std::make_unique<compiled_pattern>(pattern, mask);
+}
+
+std::unique_ptr<compiled_pattern> pattern_scanner::CompileMasked(
+    const byte* pattern, const byte* byte_masks, size_t length) const
+{
+    const compiled_pattern widened(pattern, byte_masks, length);
+
+    std::unique_ptr<compiled_pattern> compiled = Compile(widened.pattern(), widened.masks());
+    compiled->bytes = widened.bytes;
+    compiled->byte_mask = widened.byte_mask;
+    compiled->widened = widened.has_partial_masks();
+
+    return compiled;
+}
+
+void pattern_scanner::ScanVerified(
+    const compiled_pattern& compiled, const byte* data, size_t length, match_sink& results) const
+{
+    if (!compiled.widened)
+    {
+        ScanInto(compiled, data, length, results);
+        return;
+    }
+
+    results.verify(&compiled);
+    ScanInto(compiled, data, length, results);
+    results.verify(nullptr);
+}
+
+void pattern_scanner::ScanAligned(
+    const compiled_pattern& compiled, const byte* data, size_t length, size_t alignment, match_sink& results) const
+{
+    if (alignment <= 1)
+    {
+        ScanVerified(compiled, data, length, results);
+        return;
+    }
+
+    results.align(alignment);
+    if (compiled.widened)
+        results.verify(&compiled);
+
+    ScanAlignedInto(compiled, data, length, alignment, results);
+
+    results.verify(nullptr);
+    results.align(1);
+}
+
+std::vector<const byte*> pattern_scanner::ScanAligned(
+    const compiled_pattern& compiled, const byte* data, size_t length, size_t alignment) const
+{
+    if (alignment <= 1)
+        return Scan(compiled, data, length);
+
+    std::vector<const byte*> results;
+    match_sink sink(results);
+
+    ScanAligned(compiled, data, length, alignment, sink);
+
+    return results;
+}
+
+void pattern_scanner::ScanAlignedInto(
+    const compiled_pattern& compiled, const byte* data, size_t length, size_t /*alignment*/, match_sink& results) const
+{
+    ScanInto(compiled, data, length, results);
+}
+
+void pattern_scanner::ScanBitmap(
+    const compiled_pattern& compiled, const byte* data, size_t length, match_bitmap& results) const
+{
+    results.reset(length);
+    match_sink sink(results, data);
+
+    ScanVerified(compiled, data, length, sink);
+}
+
+std::vector<const byte*> pattern_scanner::Scan(const compiled_pattern& compiled, const byte* data, size_t length) const
+{
+    std::vector<const byte*> results;
+    match_sink sink(results);
+
+    ScanVerified(compiled, data, length, sink);
+
+    return results;
+}
+
+const byte* pattern_scanner::ScanFirst(const compiled_pattern& compiled, const byte* data, size_t length) const
+{
+    const byte* result = nullptr;
+    match_sink sink(&result, 1);
+
+    ScanVerified(compiled, data, length, sink);
+
+    return result;
+}
+
+size_t pattern_scanner::CountMatches(
+    const compiled_pattern& compiled, const byte* data, size_t length, size_t max_results) const
+{
+    if (max_results == 0)
+        return 0;
+
+    match_sink sink(nullptr, max_results);
+
+    ScanVerified(compiled, data, length, sink);
+
+    return sink.size();
+}
+
+std::vector<const byte*> pattern_scanner::ScanBounded(
+    const compiled_pattern& compiled, const byte* data, size_t length, size_t max_results) const
+{
+    std::vector<const byte*> results;
+    if (max_results == 0)
+        return results;
+
+    match_sink sink(results, max_results);
+
+    ScanVerified(compiled, data, length, sink);
+
+    return results;
+}
+
+std::vector<const byte*> pattern_scanner::Scan(
+    const byte* pattern, const char* mask, const byte* data, size_t length) const
+{
+    return Scan(*Compile(pattern, mask), data, length);
+}
+
+void pattern_scanner::ScanRegions(
+    const compiled_pattern& compiled, const scan_region* regions, size_t count, match_sink& results) const
+{
+    for (size_t i = 0; i < count && !results.full(); ++i)
+        ScanVerified(compiled, regions[i].data, regions[i].length, results);
+}
+
+std::vector<const byte*> pattern_scanner::ScanRegions(
+    const compiled_pattern& compiled, const scan_region* regions, size_t count) const
+{
+    std::vector<const byte*> results;
+    match_sink sink(results);
+
+    ScanRegions(compiled, regions, count, sink);
+
+    return results;
+}
+
+std::vector<std::vector<const byte*>> pattern_scanner::ScanMany(
+    const byte* const* patterns, const char* const* masks, size_t count, const byte* data, size_t length) const
+{
+    std::vector<std::vector<const byte*>> results(count);
+
+    for (size_t i = 0; i < count; ++i)
+        results[i] = Scan(patterns[i], masks[i], data, length);
+
+    return results;
+}
+
+stream_scanner::stream_scanner(const pattern_scanner& scanner, const compiled_pattern& pattern)
+    : scanner_(scanner)
+    , pattern_(pattern)
+{
+    const size_t overlap = pattern.size() ? (pattern.size() - 1) : 0;
+
+    seam_.reserve(overlap * 2);
+}
+
+void stream_scanner::Feed(const byte* chunk, size_t length, std::vector<size_t>& offsets)
+{
+    const size_t overlap = pattern_.size() ? (pattern_.size() - 1) : 0;
+
+    // Matches starting in the carried tail can only end within the first `overlap` bytes of this chunk.
+    // Scan just that seam and keep the hits that start in the tail; the chunk itself covers everything else.
+    const size_t head = (std::min)(length, overlap);
+    seam_.resize(carry_);
+    seam_.insert(seam_.end(), chunk, chunk + head);
+
+    if (carry_ != 0)
+    {
+        hits_.clear();
+        match_sink sink(hits_);
+        scanner_.ScanVerified(pattern_, seam_.data(), seam_.size(), sink);
+
+        const size_t seam_start = position_ - carry_;
+        for (const byte* hit : hits_)
+        {
+            const size_t index = static_cast<size_t>(hit - seam_.data());
+            if (index < carry_)
+                offsets.push_back(seam_start + index);
+        }
+    }
+
+    hits_.clear();
+    match_sink sink(hits_);
+    scanner_.ScanVerified(pattern_, chunk, length, sink);
+
+    for (const byte* hit : hits_)
+        offsets.push_back(position_ + static_cast<size_t>(hit - chunk));
+
+    // Keep the last `overlap` bytes of everything seen so far. A short chunk extends the previous tail.
+    if (length >= overlap)
+    {
+        seam_.assign(chunk + length - overlap, chunk + length);
+    }
+    else if (seam_.size() > overlap)
+    {
+        seam_.erase(seam_.begin(), seam_.end() - overlap);
+    }
+
+    carry_ = seam_.size();
+    position_ += length;
+}
+
+void stream_scanner::Reset() noexcept
+{
+    seam_.clear();
+    carry_ = 0;
+    position_ = 0;
+}
 
 std::vector<const byte*> FindPatternSimple(const byte* data, size_t length, const byte* pattern, const char* masks)
+{
+    std::vector<const byte*> results;
+    match_sink sink(results);
+
+    FindPatternSimple(data, length, pattern, masks, sink);
+
+    return results;
+}
+
+void FindPatternSimple(const byte* data, size_t length, const byte* pattern, const char* masks, match_sink& results)
 {
     size_t pattern_length = strlen(masks);
 
     if (pattern_length > length)
     {
-        return {};
+        return;
     }
 
-    std::vector<const byte*> results;
-
     length -= pattern_length;
 
     for (size_t i = 0; i <= length; ++i)
@@ -48,15 +376,55 @@ std::vector<const byte*> FindPatternSimple(const byte* data, size_t length, cons
             }
         }
 
-        if (found)
+        if (found && !results.push(data + i))
         {
-            results.push_back(data + i);
+            break;
         }
     }
+}
+
+std::vector<const byte*> FindPatternSimple(
+    const byte* data, size_t length, const byte* pattern, const byte* byte_masks, size_t pattern_length)
+{
+    std::vector<const byte*> results;
+    match_sink sink(results);
+
+    FindPatternSimple(data, length, pattern, byte_masks, pattern_length, sink);
 
     return results;
 }
 
+void FindPatternSimple(const byte* data, size_t length, const byte* pattern, const byte* byte_masks,
+    size_t pattern_length, match_sink& results)
+{
+    if (pattern_length > length)
+    {
+        return;
+    }
+
+    length -= pattern_length;
+
+    for (size_t i = 0; i <= length; ++i)
+    {
+        bool found = true;
+
+        for (size_t j = 0; j < pattern_length; ++j)
+        {
+            if (((data[i + j] ^ pattern[j]) & byte_masks[j]) != 0)
+            {
+                found = false;
+
+                break;
+            }
+        }
+
+        if (found && !results.push(data + i))
+        {
+            break;
+        }
+    }
+}
+
 static inline char hex_upper(unsigned int v)
 {
     return static_cast<char>((v < 10u) ? ('0' + v) : ('A' + (v - 10u)));